@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Defer.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// A minimal benchmark harness, in the spirit of Google Benchmark:
+//
+//   BENCHMARK(read_lines, 1000, 100000)
+//   {
+//       ... setup using state.arg() ...
+//       while (state.keep_running()) {
+//           ... measured work ...
+//       }
+//   }
+//
+// Each benchmark body is run repeatedly with a growing iteration count until one run takes at
+// least the minimum time, then the per-iteration time of several such runs is reported.
+#define BENCHMARK(NAME, ...)                                                                   \
+    static void TOKEN_PASTE(bench_, NAME)(lldbg::bench::State& state);                        \
+    static const bool TOKEN_PASTE(bench_registered_, NAME) = lldbg::bench::register_benchmark( \
+        #NAME, TOKEN_PASTE(bench_, NAME), std::vector<int64_t>{__VA_ARGS__});                  \
+    static void TOKEN_PASTE(bench_, NAME)(lldbg::bench::State& state)
+
+namespace lldbg::bench {
+
+class State final {
+    const int64_t m_arg;
+    const uint64_t m_max_iterations;
+    uint64_t m_iterations = 0;
+    uint64_t m_start_ns = 0;
+    uint64_t m_elapsed_ns = 0;
+    uint64_t m_items_processed = 0;
+    std::string m_label;
+    std::optional<std::string> m_skip_reason;
+
+public:
+    State(int64_t arg, uint64_t max_iterations) : m_arg(arg), m_max_iterations(max_iterations) {}
+
+    int64_t arg() const { return m_arg; }
+
+    // The measured loop; timing starts on the first call and stops once it returns false
+    bool keep_running();
+
+    // Excludes per-iteration setup from the measurement
+    void pause_timing();
+    void resume_timing();
+
+    // Reported as throughput in addition to the time per iteration
+    void set_items_processed(uint64_t items) { m_items_processed = items; }
+
+    // Extra context printed next to the results, e.g. which inferior was used
+    void set_label(const std::string& label) { m_label = label; }
+
+    // For benchmarks whose requirements (e.g. an inferior) weren't provided
+    void skip(const std::string& reason) { m_skip_reason = reason; }
+
+    uint64_t iterations() const { return m_iterations; }
+    uint64_t elapsed_ns() const { return m_elapsed_ns; }
+    uint64_t items_processed() const { return m_items_processed; }
+    const std::string& label() const { return m_label; }
+    const std::optional<std::string>& skip_reason() const { return m_skip_reason; }
+};
+
+using BenchmarkFunction = void (*)(State&);
+
+bool register_benchmark(const char* name, BenchmarkFunction function, std::vector<int64_t> args);
+
+// Command line options, shared with benchmarks that need an inferior to debug
+struct Options {
+    std::optional<std::string> filter;
+    double min_time_s = 0.2;
+    int repetitions = 3;
+    bool csv = false;
+    std::vector<std::string> inferiors;
+};
+
+const Options& options();
+
+// A directory for generated input files, removed when the benchmarks finish
+const std::filesystem::path& scratch_directory();
+
+// Runs the cleanup once the benchmarks finish, before main returns, e.g. to release a debugger
+// while LLDB can still be terminated properly. Cleanups run in reverse order of registration.
+void at_finish(std::function<void()> cleanup);
+
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace lldbg::bench
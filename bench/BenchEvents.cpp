@@ -0,0 +1,78 @@
+#include "Bench.hpp"
+
+#include "LLDBEventListenerThread.hpp"
+
+#include <thread>
+
+// Pushing and then popping a batch of 'arg' events on a single thread
+BENCHMARK(event_queue_push_pop, 1, 1024)
+{
+    lldbg::EventQueue queue;
+    const lldb::SBEvent event;
+
+    while (state.keep_running()) {
+        for (int64_t i = 0; i < state.arg(); i++) {
+            queue.push(event);
+        }
+        while (std::optional<lldb::SBEvent> popped = queue.pop()) {
+            lldbg::bench::do_not_optimize(popped);
+        }
+    }
+
+    state.set_items_processed(state.iterations() * state.arg());
+}
+
+// One thread pushing 'arg' events while another pops them, like the listener and render threads
+BENCHMARK(event_queue_producer_consumer, 100000)
+{
+    const lldb::SBEvent event;
+
+    while (state.keep_running()) {
+        lldbg::EventQueue queue;
+        const int64_t num_events = state.arg();
+
+        std::thread producer([&] {
+            for (int64_t i = 0; i < num_events; i++) {
+                queue.push(event);
+            }
+        });
+
+        int64_t received = 0;
+        while (received < num_events) {
+            if (queue.pop()) {
+                received++;
+            }
+        }
+
+        producer.join();
+    }
+
+    state.set_items_processed(state.iterations() * state.arg());
+}
+
+// Like the headless driver, which blocks waiting for the next event
+BENCHMARK(event_queue_wait_pop, 100000)
+{
+    const lldb::SBEvent event;
+
+    while (state.keep_running()) {
+        lldbg::EventQueue queue;
+        const int64_t num_events = state.arg();
+
+        std::thread producer([&] {
+            for (int64_t i = 0; i < num_events; i++) {
+                queue.push(event);
+            }
+        });
+
+        for (int64_t received = 0; received < num_events;) {
+            if (queue.wait_pop(std::chrono::milliseconds(100))) {
+                received++;
+            }
+        }
+
+        producer.join();
+    }
+
+    state.set_items_processed(state.iterations() * state.arg());
+}
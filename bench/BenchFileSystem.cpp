@@ -0,0 +1,176 @@
+#include "Bench.hpp"
+
+#include "FileSystem.hpp"
+
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// A source file of 'num_lines' lines of typical length, generated once per size
+fs::path generated_source_file(int64_t num_lines)
+{
+    const fs::path path = lldbg::bench::scratch_directory() / ("source_" + std::to_string(num_lines) + ".cpp");
+
+    if (!fs::exists(path)) {
+        std::ofstream out(path);
+        for (int64_t i = 0; i < num_lines; i++) {
+            out << "    const int value_" << i << " = compute_something(argument_" << i % 7 << ", " << i
+                << ");  // comment\n";
+        }
+    }
+
+    return path;
+}
+
+// A directory tree with 'fanout' entries per directory, the last level being regular files
+fs::path generated_tree(const std::string& name, int fanout, int depth)
+{
+    const fs::path root = lldbg::bench::scratch_directory() / name;
+
+    if (!fs::exists(root)) {
+        std::vector<fs::path> level = {root};
+        fs::create_directories(root);
+
+        for (int d = 0; d < depth; d++) {
+            std::vector<fs::path> next_level;
+            for (const fs::path& directory : level) {
+                for (int i = 0; i < fanout; i++) {
+                    const fs::path child = directory / ("entry_" + std::to_string(i));
+                    if (d + 1 == depth) {
+                        std::ofstream(child.string() + ".cpp") << "int main() {}\n";
+                    }
+                    else {
+                        fs::create_directory(child);
+                        next_level.push_back(child);
+                    }
+                }
+            }
+            level = std::move(next_level);
+        }
+    }
+
+    return root;
+}
+
+std::vector<std::string> breakpoint_files()
+{
+    const fs::path directory = generated_tree("breakpoint_files", 100, 1);
+
+    std::vector<std::string> files;
+    for (int i = 0; i < 100; i++) {
+        files.push_back((directory / ("entry_" + std::to_string(i) + ".cpp")).string());
+    }
+    return files;
+}
+
+size_t open_all(lldbg::FileBrowserNode& node)
+{
+    size_t count = 1;
+    if (node.is_directory()) {
+        node.open_children();
+        for (auto& child : node.children) {
+            count += open_all(*child);
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+BENCHMARK(read_lines, 1000, 100000)
+{
+    const fs::path path = generated_source_file(state.arg());
+
+    while (state.keep_running()) {
+        std::vector<std::string> lines = lldbg::read_lines(path);
+        lldbg::bench::do_not_optimize(lines.data());
+    }
+
+    state.set_items_processed(state.iterations() * state.arg());
+}
+
+// The first open of a file reads it from disk
+BENCHMARK(open_files_cold, 1000, 100000)
+{
+    const std::string path = generated_source_file(state.arg()).string();
+
+    while (state.keep_running()) {
+        lldbg::OpenFiles open_files;
+        lldbg::bench::do_not_optimize(open_files.open(path));
+    }
+}
+
+// Re-focusing an already open file, as when stepping through the same file
+BENCHMARK(open_files_refocus, 1000)
+{
+    const std::string path = generated_source_file(state.arg()).string();
+    lldbg::OpenFiles open_files;
+    open_files.open(path);
+
+    while (state.keep_running()) {
+        lldbg::bench::do_not_optimize(open_files.open(path));
+    }
+}
+
+BENCHMARK(file_browser_open_children, 100, 10000)
+{
+    const fs::path root = generated_tree("flat_" + std::to_string(state.arg()), (int)state.arg(), 1);
+
+    while (state.keep_running()) {
+        std::unique_ptr<lldbg::FileBrowserNode> node = lldbg::FileBrowserNode::create(root);
+        node->open_children();
+        lldbg::bench::do_not_optimize(node->children.size());
+    }
+
+    state.set_items_processed(state.iterations() * state.arg());
+}
+
+// Expanding every directory of a tree with 'arg' entries per directory, four levels deep
+BENCHMARK(file_browser_open_tree, 4, 10)
+{
+    const fs::path root = generated_tree("tree_" + std::to_string(state.arg()), (int)state.arg(), 4);
+    size_t num_nodes = 0;
+
+    while (state.keep_running()) {
+        std::unique_ptr<lldbg::FileBrowserNode> node = lldbg::FileBrowserNode::create(root);
+        num_nodes = open_all(*node);
+    }
+
+    state.set_items_processed(state.iterations() * num_nodes);
+}
+
+// 'arg' breakpoints spread over 100 files
+BENCHMARK(breakpoint_set_add, 1000, 100000)
+{
+    const std::vector<std::string> files = breakpoint_files();
+
+    while (state.keep_running()) {
+        lldbg::BreakPointSet breakpoints;
+        for (int64_t i = 0; i < state.arg(); i++) {
+            breakpoints.Add(files[i % files.size()], (int)(i / files.size()) + 1);
+        }
+        lldbg::bench::do_not_optimize(breakpoints.size());
+    }
+
+    state.set_items_processed(state.iterations() * state.arg());
+}
+
+// Looking up the breakpoints of one file among 100, each with 'arg' breakpoints
+BENCHMARK(breakpoint_set_get, 10, 10000)
+{
+    const std::vector<std::string> files = breakpoint_files();
+
+    lldbg::BreakPointSet breakpoints;
+    for (const std::string& file : files) {
+        for (int64_t line = 1; line <= state.arg(); line++) {
+            breakpoints.Add(file, (int)line);
+        }
+    }
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        lldbg::bench::do_not_optimize(breakpoints.Get(files[i++ % files.size()]).size());
+    }
+}
@@ -0,0 +1,83 @@
+#include "Bench.hpp"
+
+#include "LineAnnotations.hpp"
+
+namespace {
+
+const char* const VIEWED_DIRECTORY = "/src/";
+const char* const VIEWED_FILE = "worker.cpp";
+
+// A thread pool of the given size, every other thread parked somewhere in the viewed file
+lldbg::StopSnapshot thread_pool_snapshot(size_t num_threads)
+{
+    lldbg::StopSnapshot snapshot;
+    snapshot.stop_id = 1;
+    snapshot.threads.resize(num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+        lldbg::ThreadSnapshot& thread = snapshot.threads[i];
+        thread.index_id = (uint32_t)i + 1;
+        thread.frames_loaded = true;
+        for (int j = 0; j < 16; j++) {
+            lldbg::FrameSnapshot frame;
+            frame.directory = VIEWED_DIRECTORY;
+            frame.file_name = j == 0 && i % 2 == 0 ? VIEWED_FILE : "pool.cpp";
+            frame.line = 100 + (int)(i % 50) * 10 + j;
+            thread.frames.push_back(frame);
+        }
+    }
+    return snapshot;
+}
+
+std::vector<lldbg::BreakpointDescription> breakpoints_in_viewed_file(size_t count)
+{
+    std::vector<lldbg::BreakpointDescription> breakpoints(count);
+    for (size_t i = 0; i < count; i++) {
+        breakpoints[i].id = (lldb::break_id_t)i + 1;
+        breakpoints[i].directory = VIEWED_DIRECTORY;
+        breakpoints[i].file_name = VIEWED_FILE;
+        breakpoints[i].line = 10 + (int)i * 7;
+    }
+    return breakpoints;
+}
+
+}  // namespace
+
+// Once per stop: every thread's innermost frame is checked against the viewed file
+BENCHMARK(line_annotations_rebuild, 100, 2000)
+{
+    lldbg::StopSnapshot snapshot = thread_pool_snapshot((size_t)state.arg());
+    const std::vector<lldbg::BreakpointDescription> breakpoints = breakpoints_in_viewed_file(64);
+    const std::string path = std::string(VIEWED_DIRECTORY) + VIEWED_FILE;
+
+    lldbg::LineAnnotationCache cache;
+    while (state.keep_running()) {
+        snapshot.stop_id++;
+        cache.update(path, &snapshot, 0, 0, breakpoints, 1);
+        lldbg::bench::do_not_optimize(cache.annotations().data());
+    }
+
+    state.set_items_processed(state.iterations() * snapshot.threads.size());
+}
+
+// Every frame: only the visible lines are looked up
+BENCHMARK(line_annotations_visible_lines, 2000)
+{
+    const lldbg::StopSnapshot snapshot = thread_pool_snapshot((size_t)state.arg());
+    const std::vector<lldbg::BreakpointDescription> breakpoints = breakpoints_in_viewed_file(64);
+    const std::string path = std::string(VIEWED_DIRECTORY) + VIEWED_FILE;
+
+    lldbg::LineAnnotationCache cache;
+    cache.update(path, &snapshot, 0, 0, breakpoints, 1);
+
+    int first_line = 1;
+    while (state.keep_running()) {
+        size_t num_annotated = 0;
+        cache.update(path, &snapshot, 0, 0, breakpoints, 1);
+        const auto visible = cache.range(first_line, first_line + 60);
+        for (const lldbg::LineAnnotation* annotation = visible.first; annotation != visible.second; ++annotation) {
+            num_annotated += annotation->thread_ids.size();
+        }
+        lldbg::bench::do_not_optimize(num_annotated);
+        first_line = first_line % 600 + 1;
+    }
+}
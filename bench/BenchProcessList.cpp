@@ -0,0 +1,46 @@
+#include "Bench.hpp"
+
+#include "ProcessList.hpp"
+
+// The first scan reads stat and cmdline of every process on the machine
+BENCHMARK(process_list_cold, 0)
+{
+    size_t num_processes = 0;
+    while (state.keep_running()) {
+        lldbg::ProcessList process_list;
+        process_list.refresh();
+        num_processes = process_list.processes().size();
+        lldbg::bench::do_not_optimize(process_list.processes().data());
+    }
+
+    state.set_items_processed(state.iterations() * num_processes);
+}
+
+// The once a second rescan while the attach window is open, which lists /proc and reads each stat
+BENCHMARK(process_list_incremental, 0)
+{
+    lldbg::ProcessList process_list;
+    process_list.refresh();
+
+    while (state.keep_running()) {
+        process_list.refresh();
+        lldbg::bench::do_not_optimize(process_list.processes().data());
+    }
+
+    state.set_items_processed(state.iterations() * process_list.processes().size());
+}
+
+// Typing into the filter box, every keystroke being a new query
+BENCHMARK(process_list_filter, 0)
+{
+    lldbg::ProcessList process_list;
+    process_list.refresh();
+    const char* queries[] = {"s", "sh", "ssh", "sshd"};
+
+    size_t i = 0;
+    while (state.keep_running()) {
+        lldbg::bench::do_not_optimize(process_list.filter(queries[i++ % 4]).size());
+    }
+
+    state.set_items_processed(state.iterations() * process_list.processes().size());
+}
@@ -0,0 +1,157 @@
+#include "Bench.hpp"
+
+#include "Application.hpp"
+#include "StopSnapshot.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Inferiors stop in this function once all of their threads and stacks are set up
+constexpr const char* STRESS_BREAK_FUNCTION = "lldbg_stress_break";
+
+// Inferiors are passed with --inferior and referred to by their index, as the benchmark argument.
+// Launching one takes a while, so the current one is kept stopped until another is requested. All
+// of them are debugged by the same Application, released when the benchmarks finish so that LLDB
+// is terminated once and before static destruction.
+class StoppedInferior final {
+    std::optional<size_t> m_index;
+    std::unique_ptr<lldbg::Application> m_app;
+    uint32_t m_session_id = 0;
+    std::string m_description;
+    bool m_has_line_breakpoints = false;
+
+    // kills the inferior and deletes its target, keeping the debugger for the next one
+    void release_inferior()
+    {
+        if (m_app && m_session_id != 0) {
+            if (lldbg::get_process(*m_app).IsValid()) {
+                lldbg::kill_process(*m_app);
+            }
+            lldbg::delete_session(*m_app, m_session_id);
+        }
+        m_session_id = 0;
+        m_index.reset();
+        m_has_line_breakpoints = false;
+    }
+
+public:
+    lldbg::Application* get(lldbg::bench::State& state)
+    {
+        const std::vector<std::string>& inferiors = lldbg::bench::options().inferiors;
+        const size_t index = (size_t)state.arg();
+
+        if (index >= inferiors.size()) {
+            state.skip("no inferior #" + std::to_string(index) + " (pass --inferior PATH)");
+            return nullptr;
+        }
+
+        if (m_index != index) {
+            release_inferior();
+
+            if (!m_app) {
+                m_app = std::make_unique<lldbg::Application>();
+                lldbg::bench::at_finish([this]() {
+                    release_inferior();
+                    m_app.reset();
+                });
+            }
+
+            const char* argv[] = {nullptr};
+            if (auto err = lldbg::create_new_target(*m_app, inferiors[index].c_str(), argv, true)) {
+                state.skip(err->msg);
+                return nullptr;
+            }
+            m_session_id = lldbg::selected_session(*m_app)->id;
+
+            lldbg::wait_for_stop(*m_app, std::chrono::seconds(30));
+            m_app->debugger.GetSelectedTarget().BreakpointCreateByName(STRESS_BREAK_FUNCTION);
+            lldbg::selected_session(*m_app)->stop_snapshot.reset();
+            lldbg::continue_process(*m_app);
+
+            if (!lldbg::wait_for_stop(*m_app, std::chrono::seconds(60))) {
+                state.skip(inferiors[index] + " did not stop in " + STRESS_BREAK_FUNCTION);
+                release_inferior();
+                return nullptr;
+            }
+
+            const lldbg::StopSnapshot& snapshot = *lldbg::selected_session(*m_app)->stop_snapshot;
+            size_t num_frames = 0;
+            for (const lldbg::ThreadSnapshot& thread : snapshot.threads) {
+                num_frames += thread.frames.size();
+            }
+
+            m_description = std::filesystem::path(inferiors[index]).filename().string() + ": " +
+                            std::to_string(snapshot.threads.size()) + " threads, " + std::to_string(num_frames) +
+                            " frames";
+            m_index = index;
+        }
+
+        state.set_label(m_description);
+        return m_app.get();
+    }
+
+    // Breakpoints on up to 'count' lines of the compile unit the inferior is stopped in
+    void add_line_breakpoints(size_t count)
+    {
+        if (m_has_line_breakpoints) {
+            return;
+        }
+
+        lldb::SBProcess process = lldbg::get_process(*m_app);
+        lldb::SBTarget target = process.GetTarget();
+        lldb::SBCompileUnit compile_unit = process.GetSelectedThread().GetFrameAtIndex(0).GetCompileUnit();
+        const char* directory = compile_unit.GetFileSpec().GetDirectory();
+        const char* file_name = compile_unit.GetFileSpec().GetFilename();
+        if (!file_name) {
+            return;
+        }
+        const std::string file = directory ? std::string(directory) + "/" + file_name : std::string(file_name);
+
+        for (uint32_t i = 0; i < compile_unit.GetNumLineEntries() && target.GetNumBreakpoints() < count; i++) {
+            target.BreakpointCreateByLocation(file.c_str(), compile_unit.GetLineEntryAtIndex(i).GetLine());
+        }
+
+        m_has_line_breakpoints = true;
+    }
+};
+
+StoppedInferior s_inferior;
+
+}  // namespace
+
+BENCHMARK(stop_snapshot_build, 0, 1, 2, 3, 4, 5, 6, 7)
+{
+    lldbg::Application* app = s_inferior.get(state);
+    if (!app) {
+        return;
+    }
+
+    lldb::SBProcess process = lldbg::get_process(*app);
+    size_t num_threads = 0;
+
+    while (state.keep_running()) {
+        const lldbg::StopSnapshot snapshot = lldbg::StopSnapshot::build(process);
+        num_threads = snapshot.threads.size();
+    }
+
+    state.set_items_processed(state.iterations() * num_threads);
+}
+
+BENCHMARK(breakpoint_set_synchronize, 0, 1, 2, 3, 4, 5, 6, 7)
+{
+    lldbg::Application* app = s_inferior.get(state);
+    if (!app) {
+        return;
+    }
+
+    s_inferior.add_line_breakpoints(1000);
+    lldbg::TargetSession* session = lldbg::selected_session(*app);
+    lldb::SBTarget target = session->target;
+
+    while (state.keep_running()) {
+        session->breakpoints.Synchronize(target);
+    }
+
+    state.set_items_processed(state.iterations() * target.GetNumBreakpoints());
+}
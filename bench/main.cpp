@@ -0,0 +1,280 @@
+#include "Bench.hpp"
+
+#include "Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+struct RegisteredBenchmark {
+    std::string name;
+    lldbg::bench::BenchmarkFunction function;
+    std::optional<int64_t> arg;
+};
+
+std::vector<RegisteredBenchmark>& registry()
+{
+    static std::vector<RegisteredBenchmark> s_registry;
+    return s_registry;
+}
+
+lldbg::bench::Options s_options;
+std::vector<std::function<void()>> s_cleanups;
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct Result {
+    uint64_t iterations;
+    double ns_per_iteration;
+    double items_per_second;
+    std::string label;
+};
+
+// Grows the iteration count until a single run lasts at least the minimum time
+std::optional<Result> run_once(const RegisteredBenchmark& benchmark, std::optional<std::string>& skip_reason)
+{
+    const uint64_t min_time_ns = (uint64_t)(s_options.min_time_s * 1e9);
+    uint64_t iterations = 1;
+
+    while (true) {
+        lldbg::bench::State state(benchmark.arg.value_or(0), iterations);
+        benchmark.function(state);
+
+        if (state.skip_reason()) {
+            skip_reason = state.skip_reason();
+            return {};
+        }
+
+        const uint64_t elapsed_ns = std::max<uint64_t>(state.elapsed_ns(), 1);
+        if (elapsed_ns >= min_time_ns || iterations >= 1000000000) {
+            const double seconds = (double)elapsed_ns / 1e9;
+            return Result{state.iterations(), (double)elapsed_ns / (double)state.iterations(),
+                          (double)state.items_processed() / seconds, state.label()};
+        }
+
+        // aim slightly past the minimum time, growing by at most 10x per attempt
+        const double scale = std::min(10.0, 1.4 * (double)min_time_ns / (double)elapsed_ns);
+        iterations = std::max(iterations + 1, (uint64_t)((double)iterations * scale));
+    }
+}
+
+void print_usage()
+{
+    std::cerr << "usage: lldbg_bench [--filter SUBSTRING] [--min-time SECONDS] [--repetitions N] [--csv]\n"
+                 "                   [--inferior PATH]...\n";
+}
+
+bool parse_options(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++) {
+        const std::string flag = argv[i];
+
+        if (flag == "--csv") {
+            s_options.csv = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char* value = argv[++i];
+
+        if (flag == "--filter") {
+            s_options.filter = value;
+        }
+        else if (flag == "--min-time") {
+            s_options.min_time_s = atof(value);
+        }
+        else if (flag == "--repetitions") {
+            s_options.repetitions = std::max(1, atoi(value));
+        }
+        else if (flag == "--inferior") {
+            s_options.inferiors.push_back(value);
+        }
+        else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string format_throughput(double items_per_second)
+{
+    char buf[64];
+    if (items_per_second >= 1e9) {
+        snprintf(buf, sizeof(buf), "%.2fG/s", items_per_second / 1e9);
+    }
+    else if (items_per_second >= 1e6) {
+        snprintf(buf, sizeof(buf), "%.2fM/s", items_per_second / 1e6);
+    }
+    else if (items_per_second >= 1e3) {
+        snprintf(buf, sizeof(buf), "%.2fk/s", items_per_second / 1e3);
+    }
+    else {
+        snprintf(buf, sizeof(buf), "%.2f/s", items_per_second);
+    }
+    return buf;
+}
+
+}  // namespace
+
+namespace lldbg::bench {
+
+bool State::keep_running()
+{
+    if (m_iterations == 0 && m_start_ns == 0) {
+        m_start_ns = now_ns();
+    }
+
+    if (m_iterations < m_max_iterations) {
+        m_iterations++;
+        return true;
+    }
+
+    m_elapsed_ns += now_ns() - m_start_ns;
+    m_start_ns = 0;
+    return false;
+}
+
+void State::pause_timing()
+{
+    m_elapsed_ns += now_ns() - m_start_ns;
+}
+
+void State::resume_timing()
+{
+    m_start_ns = now_ns();
+}
+
+bool register_benchmark(const char* name, BenchmarkFunction function, std::vector<int64_t> args)
+{
+    if (args.empty()) {
+        registry().push_back({name, function, {}});
+    }
+
+    for (int64_t arg : args) {
+        registry().push_back({std::string(name) + "/" + std::to_string(arg), function, arg});
+    }
+
+    return true;
+}
+
+void at_finish(std::function<void()> cleanup)
+{
+    s_cleanups.push_back(std::move(cleanup));
+}
+
+const Options& options()
+{
+    return s_options;
+}
+
+const std::filesystem::path& scratch_directory()
+{
+    static const std::filesystem::path s_directory = [] {
+        const std::filesystem::path directory =
+            std::filesystem::temp_directory_path() / ("lldbg_bench_" + std::to_string(getpid()));
+        std::filesystem::create_directories(directory);
+        return directory;
+    }();
+    return s_directory;
+}
+
+}  // namespace lldbg::bench
+
+int main(int argc, char** argv)
+{
+    if (!parse_options(argc, argv)) {
+        print_usage();
+        return 2;
+    }
+
+    // only problems are worth reporting, debug messages would be part of the measurements
+    lldbg::g_logger = std::make_unique<lldbg::Logger>(lldbg::LogLevel::Warning);
+
+    std::vector<RegisteredBenchmark> benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+              [](const RegisteredBenchmark& a, const RegisteredBenchmark& b) { return a.name < b.name; });
+
+    if (s_options.csv) {
+        std::cout << "name,iterations,ns_per_iteration,items_per_second,label\n";
+    }
+    else {
+        printf("%-56s %12s %14s %14s\n", "benchmark", "iterations", "time/iter", "throughput");
+    }
+
+    for (const RegisteredBenchmark& benchmark : benchmarks) {
+        if (s_options.filter && benchmark.name.find(*s_options.filter) == std::string::npos) {
+            continue;
+        }
+
+        std::optional<std::string> skip_reason;
+        std::vector<Result> results;
+        for (int r = 0; r < s_options.repetitions && !skip_reason; r++) {
+            if (std::optional<Result> result = run_once(benchmark, skip_reason)) {
+                results.push_back(*result);
+            }
+        }
+
+        lldbg::g_logger->drain();
+
+        if (skip_reason) {
+            if (!s_options.csv) {
+                printf("%-56s skipped: %s\n", benchmark.name.c_str(), skip_reason->c_str());
+            }
+            continue;
+        }
+
+        // the median repetition is the least sensitive to noise from the rest of the system
+        std::sort(results.begin(), results.end(),
+                  [](const Result& a, const Result& b) { return a.ns_per_iteration < b.ns_per_iteration; });
+        const Result& median = results[results.size() / 2];
+
+        if (s_options.csv) {
+            std::cout << benchmark.name << ',' << median.iterations << ',' << median.ns_per_iteration << ','
+                      << median.items_per_second << ',' << median.label << '\n';
+        }
+        else {
+            char time[32];
+            if (median.ns_per_iteration >= 1e6) {
+                snprintf(time, sizeof(time), "%.3f ms", median.ns_per_iteration / 1e6);
+            }
+            else if (median.ns_per_iteration >= 1e3) {
+                snprintf(time, sizeof(time), "%.3f us", median.ns_per_iteration / 1e3);
+            }
+            else {
+                snprintf(time, sizeof(time), "%.1f ns", median.ns_per_iteration);
+            }
+
+            printf("%-56s %12llu %14s %14s  %s\n", benchmark.name.c_str(), (unsigned long long)median.iterations,
+                   time, median.items_per_second > 0 ? format_throughput(median.items_per_second).c_str() : "",
+                   median.label.c_str());
+        }
+        fflush(stdout);
+    }
+
+    for (auto it = s_cleanups.rbegin(); it != s_cleanups.rend(); ++it) {
+        (*it)();
+    }
+    s_cleanups.clear();
+    lldbg::g_logger->drain();
+
+    std::error_code ignored;
+    std::filesystem::remove_all(lldbg::bench::scratch_directory(), ignored);
+
+    lldbg::g_logger.reset(nullptr);
+
+    return 0;
+}
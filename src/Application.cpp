@@ -2,785 +2,478 @@
 
 #include "Defer.hpp"
 #include "Log.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
 
 #include <assert.h>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
-#include <queue>
 #include <thread>
 
-#include <GL/freeglut.h>
-#include <imgui_internal.h>
-#include "examples/imgui_impl_freeglut.h"
-#include "examples/imgui_impl_opengl2.h"
-#include "imgui.h"
-
 namespace fs = std::filesystem;
 
-namespace {
+namespace lldbg {
 
-// A convenience struct for extracting pertinent display information from an lldb::SBFrame
-struct StackFrameDescription {
-    std::string function_name;
-    std::string file_name;
-    std::string directory;
-    int line = -1;
-    int column = -1;
-
-    static StackFrameDescription build(lldb::SBFrame frame)
-    {
-        StackFrameDescription description;
-
-        description.function_name = build_string(frame.GetDisplayFunctionName());
-        description.file_name = build_string(frame.GetLineEntry().GetFileSpec().GetFilename());
-        description.directory = build_string(frame.GetLineEntry().GetFileSpec().GetDirectory());
-        description.directory.append("/");  // FIXME: not cross-platform
-        description.line = (int)frame.GetLineEntry().GetLine();
-        description.column = (int)frame.GetLineEntry().GetColumn();
-
-        return description;
-    }
-};
-
-bool MyTreeNode(const char* label)
-{
-    ImGuiContext& g = *GImGui;
-    ImGuiWindow* window = g.CurrentWindow;
-
-    ImGuiID id = window->GetID(label);
-    ImVec2 pos = window->DC.CursorPos;
-    ImRect bb(pos, ImVec2(pos.x + ImGui::GetContentRegionAvail().x,
-                          pos.y + g.FontSize + g.Style.FramePadding.y * 2));
-    bool opened = ImGui::TreeNodeBehaviorIsOpen(id);
-    bool hovered, held;
-    if (ImGui::ButtonBehavior(bb, id, &hovered, &held, true))
-        window->DC.StateStorage->SetInt(id, opened ? 0 : 1);
-    if (hovered || held)
-        window->DrawList->AddRectFilled(
-            bb.Min, bb.Max, ImGui::GetColorU32(held ? ImGuiCol_HeaderActive : ImGuiCol_HeaderHovered));
-
-    // Icon, text
-    float button_sz = g.FontSize + g.Style.FramePadding.y * 2;
-    // TODO: set colors from style?
-    window->DrawList->AddRectFilled(pos, ImVec2(pos.x + button_sz, pos.y + button_sz),
-                                    opened ? ImColor(51, 105, 173) : ImColor(42, 79, 130));
-    ImGui::RenderText(ImVec2(pos.x + button_sz + g.Style.ItemInnerSpacing.x, pos.y + g.Style.FramePadding.y),
-                      label);
-
-    ImGui::ItemSize(bb, g.Style.FramePadding.y);
-    ImGui::ItemAdd(bb, id);
-
-    if (opened) ImGui::TreePush(label);
-    return opened;
-}
-
-bool Splitter(const char* name, bool split_vertically, float thickness, float* size1, float* size2,
-              float min_size1, float min_size2, float splitter_long_axis_size)
-{
-    using namespace ImGui;
-    ImGuiContext& g = *GImGui;
-    ImGuiWindow* window = g.CurrentWindow;
-    ImGuiID id = window->GetID(name);
-    ImRect bb;
-    bb.Min = window->DC.CursorPos + (split_vertically ? ImVec2(*size1, 0.0f) : ImVec2(0.0f, *size1));
-    bb.Max = bb.Min + CalcItemSize(split_vertically ? ImVec2(thickness, splitter_long_axis_size)
-                                                    : ImVec2(splitter_long_axis_size, thickness),
-                                   0.0f, 0.0f);
-    return SplitterBehavior(bb, id, split_vertically ? ImGuiAxis_X : ImGuiAxis_Y, size1, size2, min_size1,
-                            min_size2, 0.0f);
-}
-
-void draw_open_files(lldbg::Application& app)
-{
-    bool closed_tab = false;
-
-    app.open_files.for_each_open_file([&](const lldbg::FileReference& ref, bool is_focused) {
-        std::optional<lldbg::OpenFiles::Action> action;
-
-        // we programmatically set the focused tab if manual tab change requested
-        // for example when the user clicks an entry in the stack trace or file explorer
-        auto tab_flags = ImGuiTabItemFlags_None;
-        if (app.render_state.request_manual_tab_change && is_focused) {
-            tab_flags = ImGuiTabItemFlags_SetSelected;
-            app.text_editor.SetTextLines(*ref.contents);
-            app.text_editor.SetBreakpoints(app.breakpoints.Get(ref.canonical_path.string()));
-        }
+namespace {
 
-        bool keep_tab_open = true;
-        if (ImGui::BeginTabItem(ref.short_name.c_str(), &keep_tab_open, tab_flags)) {
-            ImGui::BeginChild("FileContents");
-            if (!app.render_state.request_manual_tab_change && !is_focused) {
-                // user selected tab directly with mouse
-                action = lldbg::OpenFiles::Action::ChangeFocusTo;
-                app.text_editor.SetTextLines(*ref.contents);
-                app.text_editor.SetBreakpoints(app.breakpoints.Get(ref.canonical_path.string()));
-            }
-            app.text_editor.Render("TextEditor");
-            ImGui::EndChild();
-            ImGui::EndTabItem();
-        }
+std::unique_ptr<SymbolPreloader> start_symbol_preload(Application& app, lldb::SBTarget target)
+{
+    if (app.symbol_preload_threads == 0) {
+        return nullptr;
+    }
+    return std::make_unique<SymbolPreloader>(target, app.symbol_preload_threads);
+}
 
-        if (!keep_tab_open) {
-            // user closed tab with mouse
-            closed_tab = true;
-            action = lldbg::OpenFiles::Action::Close;
-        }
+}  // namespace
 
-        return action;
-    });
+Application::Application()
+{
+    // LLDBG_SB_TRACE=<directory> traces SB API calls from startup and saves the results on exit
+    if (getenv("LLDBG_SB_TRACE")) {
+        g_sb_trace.set_enabled(true);
+    }
 
-    app.render_state.request_manual_tab_change = false;
+    lldb::SBDebugger::Initialize();
+    debugger = lldb::SBDebugger::Create();
+    debugger.SetAsync(true);
+    command_line.replace_interpreter(SB_CALL(Command, debugger.GetCommandInterpreter()));
+    command_line.run_command("settings set auto-confirm 1", true);
+    command_line.run_command("settings set target.x86-disassembly-flavor intel", true);
 
-    if (closed_tab && app.open_files.size() > 0) {
-        const lldbg::FileReference ref = *app.open_files.focus();
-        app.text_editor.SetTextLines(*ref.contents);
-        app.text_editor.SetBreakpoints(app.breakpoints.Get(ref.canonical_path.string()));
-    }
+    // listens to every target and process, including those created later
+    event_listener.start(debugger);
 }
 
-void draw_file_browser(lldbg::Application& app, lldbg::FileBrowserNode* node_to_draw, size_t depth)
+Application::~Application()
 {
-    if (node_to_draw->is_directory()) {
-        const char* tree_node_label = depth == 0 ? node_to_draw->full_path() : node_to_draw->filename();
-
-        if (MyTreeNode(tree_node_label)) {
-            node_to_draw->open_children();
-            for (auto& child_node : node_to_draw->children) {
-                draw_file_browser(app, child_node.get(), depth + 1);
-            }
-            ImGui::TreePop();
-        }
+    if (const char* trace_directory = getenv("LLDBG_SB_TRACE")) {
+        g_sb_trace.write_histograms(fs::path(trace_directory) / "lldbg_sb_histograms.txt");
+        g_sb_trace.write_chrome_trace(fs::path(trace_directory) / "lldbg_sb_trace.json");
     }
-    else {
-        if (ImGui::Selectable(node_to_draw->filename())) {
-            manually_open_and_or_focus_file(app, node_to_draw->full_path());
-        }
-    }
-}
 
-}  // namespace
+    // nothing may still be using the debugger from another thread once it is terminated
+    cancel_attach(*this);
+    pending_attach.reset();
+    for (std::unique_ptr<TargetSession>& session : sessions) {
+        session->symbols.reset();
+        session->thread_groups.cancel();
+    }
 
-namespace lldbg {
+    event_listener.stop(debugger);
+    lldb::SBDebugger::Terminate();
+}
 
-void draw(Application& app)
+const std::optional<TargetStartError> create_new_target(Application& app, const char* exe_filepath,
+                                                        const char** argv, bool delay_start,
+                                                        std::optional<std::string> workdir)
 {
-    lldb::SBProcess process = get_process(app);
-    const bool stopped = process.GetState() == lldb::eStateStopped;
+    std::error_code fs_error;
+    const fs::path full_exe_path = fs::canonical(exe_filepath, fs_error);
 
-    // ImGuiIO& io = ImGui::GetIO();
-    // io.FontGlobalScale = 1.1;
+    if (fs_error || !fs::exists(full_exe_path)) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::ExecutableDoesNotExist;
+        error.msg = "Requested executable does not exist: " + std::string(exe_filepath);
+        return error;
+    }
 
-    static int window_width = glutGet(GLUT_WINDOW_WIDTH);
-    static int window_height = glutGet(GLUT_WINDOW_HEIGHT);
+    // TODO: only set file browser node once we know the process has started successfully
+    if (workdir && fs::exists(*workdir) && fs::is_directory(*workdir)) {
+        app.file_browser = FileBrowserNode::create(*workdir);
+    }
+    else if (full_exe_path.has_parent_path()) {
+        app.file_browser = FileBrowserNode::create(full_exe_path.parent_path());
+    }
+    else {
+        app.file_browser = FileBrowserNode::create(fs::current_path());
+    }
 
-    bool window_resized = false;
-    const int old_width = window_width;
-    const int old_height = window_height;
-    const int new_width = glutGet(GLUT_WINDOW_WIDTH);
-    const int new_height = glutGet(GLUT_WINDOW_HEIGHT);
-    if (new_width != old_width || new_height != old_height) {
-        window_width = new_width;
-        window_height = new_height;
-        window_resized = true;
+    if (app.file_browser) {
+        app.command_line.open_persistent_history(app.file_browser->full_path());
     }
 
-    ImGui::SetNextWindowPos(ImVec2(0.f, 0.f), ImGuiSetCond_Always);
-    ImGui::SetNextWindowSize(ImVec2(window_width, window_height), ImGuiSetCond_Always);
+    // TODO: loop through running processes (if any) and kill them and log information about it.
+    lldb::SBError lldb_error;
+    lldb::SBTarget new_target =
+        app.debugger.CreateTarget(full_exe_path.c_str(), nullptr, nullptr, true, lldb_error);
 
-    ImGui::Begin("lldbg", 0,
-                 ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_MenuBar |
-                     ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse |
-                     ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoTitleBar);
-    ImGui::PushFont(app.render_state.font);
+    if (!lldb_error.Success()) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::TargetCreation;
+        const char* lldb_error_cstr = lldb_error.GetCString();
+        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown target creation error!";
+        return error;
+    }
 
-    if (ImGui::BeginMenuBar()) {
-        Defer(ImGui::EndMenuBar());
+    LOG(Debug) << "Succesfully created target for executable: " << full_exe_path;
 
-        if (ImGui::BeginMenu("File")) {
-            Defer(ImGui::EndMenu());
-            if (ImGui::MenuItem("Open..", "Ctrl+O")) { /* Do stuff */
-            }
-            if (ImGui::MenuItem("Save", "Ctrl+S")) { /* Do stuff */
-            }
-            if (ImGui::MenuItem("Close", "Ctrl+W")) { /* Do stuff */
-            }
-        }
+    // overlaps with launching the process
+    std::unique_ptr<SymbolPreloader> symbols = start_symbol_preload(app, new_target);
 
-        if (ImGui::BeginMenu("View")) {
-            Defer(ImGui::EndMenu());
-            if (ImGui::MenuItem("Layout", NULL)) { /* Do stuff */
-            }
-            if (ImGui::MenuItem("Zoom In", "+")) { /* Do stuff */
-            }
-            if (ImGui::MenuItem("Zoom Out", "-")) { /* Do stuff */
-            }
-        }
+    lldb::SBLaunchInfo launch_info(argv);
+    launch_info.SetLaunchFlags(lldb::eLaunchFlagDisableASLR | lldb::eLaunchFlagStopAtEntry);
+    lldb::SBProcess process = new_target.Launch(launch_info, lldb_error);
 
-        if (ImGui::BeginMenu("Help")) {
-            Defer(ImGui::EndMenu());
-            if (ImGui::MenuItem("About", "F12")) { /* Do stuff */
-            }
-        }
+    if (!lldb_error.Success()) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::Launch;
+        const char* lldb_error_cstr = lldb_error.GetCString();
+        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown target launch error!";
+        LOG(Error) << "Failed to launch process, destroying target...";
+        symbols.reset();
+        app.debugger.DeleteTarget(new_target);
+        return error;
     }
 
-    static float file_browser_width =
-        (float)window_width * app.render_state.DEFAULT_FILEBROWSER_WIDTH_PERCENT;
-    static float file_viewer_width = (float)window_width * app.render_state.DEFAULT_FILEVIEWER_WIDTH_PERCENT;
-    Splitter("##S1", true, 3.0f, &file_browser_width, &file_viewer_width, 100, 100, window_height);
+    LOG(Debug) << "Succesfully launched process for executable: " << full_exe_path;
+
+    // no need to wait for the process to be ready, its stop at entry arrives as an event
+    auto session = std::make_unique<TargetSession>();
+    session->id = app.next_session_id++;
+    session->target = new_target;
+    session->symbols = std::move(symbols);
+    select_session(app, *session);
 
-    if (window_resized) {
-        file_browser_width = file_browser_width * (float)new_width / (float)old_width;
-        file_viewer_width = file_viewer_width * (float)new_width / (float)old_width;
+    // the stop at entry may have been handled before the session existed
+    if (SB_CALL(Process, process.GetState()) == lldb::eStateStopped) {
+        session->stop_snapshot = StopSnapshot::build(process);
     }
 
-    ImGui::BeginChild("FileBrowserPane", ImVec2(file_browser_width, 0));
+    app.sessions.push_back(std::move(session));
 
-    if (ImGui::Button("Resume")) {
+    if (!delay_start) {
         get_process(app).Continue();
     }
-    ImGui::SameLine();
 
-    if (ImGui::Button("Stop")) {
-        get_process(app).Stop();
-    }
-    ImGui::Separator();
+    return {};
+}
 
-    draw_file_browser(app, app.file_browser.get(), 0);
-    ImGui::EndChild();
+const std::optional<TargetStartError> open_core_file(Application& app, const char* exe_filepath,
+                                                     const char* core_filepath)
+{
+    std::error_code fs_error;
+    const fs::path full_exe_path = fs::canonical(exe_filepath, fs_error);
+    if (fs_error) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::ExecutableDoesNotExist;
+        error.msg = "Requested executable does not exist: " + std::string(exe_filepath);
+        return error;
+    }
 
-    ImGui::SameLine();
+    if (!fs::is_regular_file(core_filepath, fs_error)) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::LoadCore;
+        error.msg = "Requested core file does not exist: " + std::string(core_filepath);
+        return error;
+    }
 
-    ImGui::BeginGroup();
+    app.file_browser = FileBrowserNode::create(full_exe_path.parent_path());
+    if (app.file_browser) {
+        app.command_line.open_persistent_history(app.file_browser->full_path());
+    }
 
-    static float file_viewer_height = window_height / 2;
-    static float console_height = window_height / 2;
+    lldb::SBError lldb_error;
+    lldb::SBTarget new_target =
+        app.debugger.CreateTarget(full_exe_path.c_str(), nullptr, nullptr, true, lldb_error);
 
-    const float old_console_height = console_height;
+    if (!lldb_error.Success()) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::TargetCreation;
+        const char* lldb_error_cstr = lldb_error.GetCString();
+        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown target creation error!";
+        return error;
+    }
 
-    Splitter("##S2", false, 3.0f, &file_viewer_height, &console_height, 100, 100, file_viewer_width);
+    lldb::SBProcess process = SB_CALL(Process, new_target.LoadCore(core_filepath, lldb_error));
 
-    if (window_resized) {
-        file_viewer_height = file_viewer_height * (float)new_height / (float)old_height;
-        console_height = console_height * (float)new_height / (float)old_height;
+    if (!lldb_error.Success() || !process.IsValid()) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::LoadCore;
+        const char* lldb_error_cstr = lldb_error.GetCString();
+        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown core file loading error!";
+        LOG(Error) << "Failed to load core file, destroying target...";
+        app.debugger.DeleteTarget(new_target);
+        return error;
     }
 
-    {  // start file viewer
-        ImGui::BeginChild("FileViewer", ImVec2(file_viewer_width, file_viewer_height));
-        if (ImGui::BeginTabBar("##FileViewerTabs",
-                               ImGuiTabBarFlags_AutoSelectNewTabs | ImGuiTabBarFlags_NoTooltip)) {
-            Defer(ImGui::EndTabBar());
+    auto session = std::make_unique<TargetSession>();
+    session->id = app.next_session_id++;
+    session->target = new_target;
+    session->is_core = true;
+    session->stop_snapshot = StopSnapshot::build(process, true);
+    session->symbols = start_symbol_preload(app, new_target);
+    select_session(app, *session);
 
-            if (app.open_files.size() == 0) {
-                if (ImGui::BeginTabItem("about")) {
-                    Defer(ImGui::EndTabItem());
-                    ImGui::TextUnformatted("This is a GUI for lldb.");
-                }
-            }
-            else {
-                draw_open_files(app);
-            }
-        }
-        ImGui::EndChild();
-    }  // end file viewer
-
-    ImGui::Spacing();
-
-    {  // start console/log
-        ImGui::BeginChild("LogConsole",
-                          ImVec2(file_viewer_width, console_height - 2 * ImGui::GetFrameHeightWithSpacing()));
-        if (ImGui::BeginTabBar("##ConsoleLogTabs", ImGuiTabBarFlags_None)) {
-            if (ImGui::BeginTabItem("Console")) {
-                ImGui::BeginChild("ConsoleEntries");
-
-                for (const lldbg::CommandLineEntry& entry : app.command_line.get_history()) {
-                    ImGui::TextColored(ImVec4(255, 0, 0, 255), "> %s", entry.input.c_str());
-                    if (entry.succeeded) {
-                        ImGui::TextUnformatted(entry.output.c_str());
-                    }
-                    else {
-                        ImGui::Text("error: %s is not a valid command.", entry.input.c_str());
-                    }
-
-                    ImGui::TextUnformatted("\n");
-                }
-
-                // always scroll to the bottom of the command history after running a command
-                const bool should_auto_scroll_command_window =
-                    app.render_state.ran_command_last_frame || old_console_height != console_height;
-
-                auto command_input_callback = [](ImGuiTextEditCallbackData* data) -> int { return 0; };
-
-                const ImGuiInputTextFlags command_input_flags = ImGuiInputTextFlags_EnterReturnsTrue;
-
-                static char input_buf[2048];
-                if (ImGui::InputText("lldb console", input_buf, 2048, command_input_flags,
-                                     command_input_callback)) {
-                    run_lldb_command(app, input_buf);
-                    strcpy(input_buf, "");
-                    app.render_state.ran_command_last_frame = true;
-                }
-
-                // Keep auto focus on the input box
-                if (ImGui::IsItemHovered() || (ImGui::IsRootWindowOrAnyChildFocused() &&
-                                               !ImGui::IsAnyItemActive() && !ImGui::IsMouseClicked(0)))
-                    ImGui::SetKeyboardFocusHere(-1);  // Auto focus previous widget
-
-                if (should_auto_scroll_command_window) {
-                    ImGui::SetScrollHere(1.0f);
-                    app.render_state.ran_command_last_frame = false;
-                }
-
-                ImGui::EndChild();
-
-                ImGui::EndTabItem();
-            }
+    LOG(Info) << "Loaded core file " << core_filepath << " with " << session->stop_snapshot->threads.size()
+              << " threads";
 
-            if (ImGui::BeginTabItem("Log")) {
-                ImGui::BeginChild("LogEntries");
-                lldbg::g_logger->for_each_message([](const lldbg::LogMessage& message) -> void {
-                    // TODO: colorize based on log level
-                    ImGui::TextUnformatted(message.message.c_str());
-                });
-                ImGui::SetScrollHere(1.0f);
-                ImGui::EndChild();
-                ImGui::EndTabItem();
-            }
-            ImGui::EndTabBar();
-        }
-        ImGui::EndChild();
-    }  // end console/log
-
-    ImGui::EndGroup();
-
-    ImGui::SameLine();
-
-    ImGui::BeginGroup();
-
-    const float threads_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
-    const float stack_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
-    const float locals_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
-    const float breakpoint_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
-
-    ImGui::BeginChild("#ThreadsChild",
-                      ImVec2(window_width - file_browser_width - file_viewer_width, threads_height));
-    if (ImGui::BeginTabBar("#ThreadsTabs", ImGuiTabBarFlags_None)) {
-        if (ImGui::BeginTabItem("Threads")) {
-            if (stopped) {
-                for (uint32_t i = 0; i < process.GetNumThreads(); i++) {
-                    char label[128];
-                    sprintf(label, "Thread %d", i);
-                    if (ImGui::Selectable(label, i == app.render_state.viewed_thread_index)) {
-                        app.render_state.viewed_thread_index = i;
-                    }
-                }
-
-                if (process.GetNumThreads() > 0 && app.render_state.viewed_thread_index < 0) {
-                    app.render_state.viewed_thread_index = 0;
-                }
-            }
-            ImGui::EndTabItem();
-        }
-        ImGui::EndTabBar();
-    }
-    ImGui::EndChild();
-
-    ImGui::BeginChild("#StackTraceChild", ImVec2(0, stack_height));
-    if (ImGui::BeginTabBar("##StackTraceTabs", ImGuiTabBarFlags_None)) {
-        if (ImGui::BeginTabItem("Stack Trace")) {
-            static int selected_row = -1;
-
-            if (stopped && app.render_state.viewed_thread_index >= 0) {
-                ImGui::Columns(3);
-                ImGui::Separator();
-                ImGui::Text("FUNCTION");
-                ImGui::NextColumn();
-                ImGui::Text("FILE");
-                ImGui::NextColumn();
-                ImGui::Text("LINE");
-                ImGui::NextColumn();
-                ImGui::Separator();
-
-                lldb::SBThread viewed_thread = process.GetThreadAtIndex(app.render_state.viewed_thread_index);
-                for (uint32_t i = 0; i < viewed_thread.GetNumFrames(); i++) {
-                    // TODO: save description and don't rebuild every frame
-                    const auto desc = StackFrameDescription::build(viewed_thread.GetFrameAtIndex(i));
-
-                    if (ImGui::Selectable(desc.function_name.c_str() ? desc.function_name.c_str() : "unknown",
-                                          (int)i == selected_row)) {
-                        // TODO: factor out
-                        const std::string full_path = desc.directory + desc.file_name;
-                        manually_open_and_or_focus_file(app, full_path.c_str());
-                        selected_row = (int)i;
-                    }
-                    ImGui::NextColumn();
-
-                    ImGui::Selectable(desc.file_name.c_str() ? desc.file_name.c_str() : "unknown",
-                                      (int)i == selected_row);
-                    ImGui::NextColumn();
-
-                    static char line_buf[256];
-                    sprintf(line_buf, "%d", desc.line);
-                    ImGui::Selectable(line_buf, (int)i == selected_row);
-                    ImGui::NextColumn();
-                }
-
-                app.render_state.viewed_frame_index = selected_row;
-                ImGui::Columns(1);
-            }
+    app.sessions.push_back(std::move(session));
 
-            ImGui::EndTabItem();
-        }
-        ImGui::EndTabBar();
-    }
-    ImGui::EndChild();
-
-    ImGui::BeginChild("#LocalsChild", ImVec2(0, locals_height));
-    if (ImGui::BeginTabBar("##LocalsTabs", ImGuiTabBarFlags_None)) {
-        if (ImGui::BeginTabItem("Locals")) {
-            // TODO: turn this into a recursive tree that displays children of structs/arrays
-            if (stopped && app.render_state.viewed_frame_index >= 0) {
-                lldb::SBThread viewed_thread = process.GetThreadAtIndex(app.render_state.viewed_thread_index);
-                lldb::SBFrame frame = viewed_thread.GetFrameAtIndex(app.render_state.viewed_frame_index);
-                lldb::SBValueList locals = frame.GetVariables(true, true, true, true);
-                for (uint32_t i = 0; i < locals.GetSize(); i++) {
-                    lldb::SBValue value = locals.GetValueAtIndex(i);
-                    ImGui::TextUnformatted(value.GetName());
-                }
-            }
-            ImGui::EndTabItem();
-        }
-        if (ImGui::BeginTabItem("Registers")) {
-            ImGui::BeginChild("RegisterContents");
-            // FIXME: why does this stall the program?
-            // if (stopped && app.render_state.viewed_frame_index >= 0) {
-            //     lldb::SBThread viewed_thread =
-            //     process.GetThreadAtIndex(app.render_state.viewed_thread_index); lldb::SBFrame frame =
-            //     viewed_thread.GetFrameAtIndex(app.render_state.viewed_frame_index); lldb::SBValueList
-            //     register_collections = frame.GetRegisters();
-
-            //     for (uint32_t i = 0; i < register_collections.GetSize(); i++) {
-            //         lldb::SBValue register_set = register_collections.GetValueAtIndex(i);
-            //         //const std::string label = std::string(register_set.GetName()) + std::to_string(i);
-            //         const std::string label = "Configuration##" + std::to_string(i);
-
-            //         if (MyTreeNode(label.c_str())) {
-
-            //             for (uint32_t i = 0; register_set.GetNumChildren(); i++) {
-            //                 lldb::SBValue child = register_set.GetChildAtIndex(i);
-            //                 if (child.GetName()) {
-            //                     ImGui::TextUnformatted(child.GetName());
-            //                 }
-            //             }
-
-            //             ImGui::TreePop();
-            //         }
-            //     }
-            // }
-            ImGui::EndChild();
-            ImGui::EndTabItem();
-        }
-        ImGui::EndTabBar();
+    return {};
+}
+
+lldb::SBValueList frame_variables(TargetSession& session, size_t thread_index, uint32_t frame_index)
+{
+    const StopSnapshot& snapshot = *session.stop_snapshot;
+    const uint64_t thread_id = snapshot.threads[thread_index].thread_id;
+
+    if (!session.variables || session.variables->stop_id != snapshot.stop_id ||
+        session.variables->thread_id != thread_id || session.variables->frame_index != frame_index) {
+        PROFILE_SCOPE("SBFrame::GetVariables");
+
+        lldb::SBThread thread = SB_CALL(Process, session.target.GetProcess().GetThreadByID(thread_id));
+        lldb::SBFrame frame = SB_CALL(Frame, thread.GetFrameAtIndex(frame_index));
+
+        TargetSession::FrameVariables variables;
+        variables.stop_id = snapshot.stop_id;
+        variables.thread_id = thread_id;
+        variables.frame_index = frame_index;
+        variables.values = SB_CALL(Variables, frame.GetVariables(true, true, true, true));
+        session.variables = std::move(variables);
     }
-    ImGui::EndChild();
 
-    ImGui::BeginChild("#BreakWatchPointChild", ImVec2(0, breakpoint_height));
-    if (ImGui::BeginTabBar("##BreakWatchPointTabs", ImGuiTabBarFlags_None)) {
-        Defer(ImGui::EndTabBar());
+    return session.variables->values;
+}
 
-        if (ImGui::BeginTabItem("Watchpoints")) {
-            Defer(ImGui::EndTabItem());
+namespace {
 
-            for (int i = 0; i < 4; i++) {
-                char label[128];
-                sprintf(label, "Watch %d", i);
-                if (ImGui::Selectable(label, i == 0)) {
-                    // blah
-                }
-            }
+TargetSession* find_session(Application& app, uint32_t session_id)
+{
+    for (std::unique_ptr<TargetSession>& session : app.sessions) {
+        if (session->id == session_id) {
+            return session.get();
         }
+    }
+    return nullptr;
+}
+
+// Keeps the viewed frame's variables if its thread didn't run, only that thread's SBValues are
+// refetched when stepping one thread of many
+void retain_frame_variables(TargetSession& session)
+{
+    if (!session.variables) {
+        return;
+    }
 
-        if (ImGui::BeginTabItem("Breakpoints")) {
-            Defer(ImGui::EndTabItem());
-
-            if (stopped && app.render_state.viewed_thread_index >= 0) {
-                static int selected_row = -1;
-
-                ImGui::Columns(2);
-                ImGui::Separator();
-                ImGui::Text("FILE");
-                ImGui::NextColumn();
-                ImGui::Text("LINE");
-                ImGui::NextColumn();
-                ImGui::Separator();
-                Defer(ImGui::Columns(1));
-
-                lldb::SBTarget target = app.debugger.GetSelectedTarget();
-                for (uint32_t i = 0; i < target.GetNumBreakpoints(); i++) {
-                    lldb::SBBreakpoint breakpoint = target.GetBreakpointAtIndex(i);
-                    lldb::SBBreakpointLocation location = breakpoint.GetLocationAtIndex(0);
-
-                    if (!location.IsValid()) {
-                        LOG(Error) << "Invalid breakpoint location encountered!";
-                    }
-
-                    lldb::SBAddress address = location.GetAddress();
-
-                    if (!address.IsValid()) {
-                        LOG(Error) << "Invalid lldb::SBAddress for breakpoint!";
-                    }
-
-                    lldb::SBLineEntry line_entry = address.GetLineEntry();
-
-                    // TODO: save description and don't rebuild every frame
-                    const std::string filename = build_string(line_entry.GetFileSpec().GetFilename());
-                    if (ImGui::Selectable(filename.c_str(), (int)i == selected_row)) {
-                        // TODO: factor out
-                        const std::string directory =
-                            build_string(line_entry.GetFileSpec().GetDirectory()) + "/";
-                        const std::string full_path = directory + filename;
-                        manually_open_and_or_focus_file(app, full_path.c_str());
-                        selected_row = (int)i;
-                    }
-                    ImGui::NextColumn();
-
-                    static char line_buf[256];
-                    sprintf(line_buf, "%d", line_entry.GetLine());
-                    ImGui::Selectable(line_buf, (int)i == selected_row);
-                    ImGui::NextColumn();
-                }
+    for (const ThreadSnapshot& thread : session.stop_snapshot->threads) {
+        if (thread.thread_id == session.variables->thread_id) {
+            if (thread.changed) {
+                break;
             }
+            session.variables->stop_id = session.stop_snapshot->stop_id;
+            return;
         }
     }
-    ImGui::EndChild();
-
-    ImGui::EndGroup();
 
-    ImGui::PopFont();
-    ImGui::End();
+    session.variables.reset();
+}
 
-    // if (app.exit_dialog) {
-    //     ImGui::SetNextWindowPos(ImVec2(window_width/2.f, window_height/2.f), ImGuiSetCond_Always);
-    //     ImGui::SetNextWindowSize(ImVec2(200, 200), ImGuiSetCond_Always);
-    //     if (ImGui::Begin("About Dear ImGui", 0, ImGuiWindowFlags_NoDecoration)) {
-    //         ImGui::TextUnformatted("asdF");
-    //     }
-    //     ImGui::End();
-    // }
+void step(lldb::SBThread thread, StepKind kind)
+{
+    switch (kind) {
+        case StepKind::Over:
+            thread.StepOver();
+            break;
+        case StepKind::Into:
+            thread.StepInto();
+            break;
+        case StepKind::Out:
+            thread.StepOut();
+            break;
+    }
 }
 
-void tick(lldbg::Application& app)
+// Records where a step of queue_steps stopped, and takes the next queued step if there is one.
+// Returns whether it did, in which case the stop is not worth a StopSnapshot.
+bool continue_rapid_step(TargetSession& session, lldb::SBProcess process)
 {
-    lldb::SBEvent event;
+    PROFILE_SCOPE("continue_rapid_step");
 
-    while (true) {
-        std::optional<lldb::SBEvent> event = app.event_listener.pop_event();
+    TargetSession::RapidStep& rapid_step = session.rapid_step;
+    rapid_step.in_flight = false;
+    rapid_step.steps_taken++;
 
-        if (event) {
-            const lldb::StateType new_state = lldb::SBProcess::GetStateFromEvent(*event);
-            const char* state_descr = lldb::SBDebugger::StateAsCString(new_state);
-            LOG(Debug) << "Found event with new state: " << state_descr;
+    lldb::SBThread thread = SB_CALL(Process, process.GetSelectedThread());
+    rapid_step.location = FrameSnapshot::build(SB_CALL(Frame, thread.GetFrameAtIndex(0)));
 
-            // TODO: make this actually be useful
-            if (new_state == lldb::eStateExited) {
-                lldbg::ExitDialog dialog;
-                dialog.process_name = "asdf";
-                dialog.exit_code = get_process(app).GetExitStatus();
-                app.exit_dialog = dialog;
-                LOG(Debug) << "Set exit dialog";
-            }
-        }
-        else {
-            break;
-        }
+    // a breakpoint, watchpoint or signal hit while stepping ends it
+    if (rapid_step.queued == 0 || SB_CALL(Thread, thread.GetStopReason()) != lldb::eStopReasonPlanComplete) {
+        rapid_step.queued = 0;
+        return false;
     }
 
-    lldbg::draw(app);
+    rapid_step.queued--;
+    rapid_step.in_flight = true;
+    step(thread, rapid_step.kind);
+    return true;
+}
 
-    std::optional<int> line_clicked = app.text_editor.LineClicked();
+const std::optional<TargetStartError> start_attach(Application& app, lldb::SBAttachInfo attach_info,
+                                                   const std::string& description)
+{
+    if (app.pending_attach) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::Attach;
+        error.msg = "Already attaching to " + app.pending_attach->description;
+        return error;
+    }
 
-    if (line_clicked) {
-        add_breakpoint_to_viewed_file(app, *line_clicked);
+    // the executable is found from the process once attached
+    lldb::SBError lldb_error;
+    lldb::SBTarget target = app.debugger.CreateTarget("", nullptr, nullptr, true, lldb_error);
+    if (!lldb_error.Success() || !target.IsValid()) {
+        TargetStartError error;
+        error.type = TargetStartError::Type::TargetCreation;
+        const char* lldb_error_cstr = lldb_error.GetCString();
+        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown target creation error!";
+        return error;
     }
-}
 
-void main_loop()
-{
-    // Start the Dear ImGui frame
-    ImGui_ImplOpenGL2_NewFrame();
-    ImGui_ImplFreeGLUT_NewFrame();
+    // not selected until attached, so that nothing else uses the target while Attach holds it
+    auto session = std::make_unique<TargetSession>();
+    session->id = app.next_session_id++;
+    session->target = target;
 
-    tick(*lldbg::g_application);
+    PendingAttach attach;
+    attach.session_id = session->id;
+    attach.description = description;
+    attach.start = std::chrono::steady_clock::now();
 
-    // Rendering
-    ImGui::Render();
-    ImGuiIO& io = ImGui::GetIO();
-    glViewport(0, 0, (GLsizei)io.DisplaySize.x, (GLsizei)io.DisplaySize.y);
-    // glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
-    glClear(GL_COLOR_BUFFER_BIT);
-    ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+    // returns once the attach is under way, the debugger being asynchronous
+    lldb::SBError attach_error;
+    target.Attach(attach_info, attach_error);
+    if (!attach_error.Success()) {
+        app.debugger.DeleteTarget(target);
+        TargetStartError error;
+        error.type = TargetStartError::Type::Attach;
+        const char* lldb_error_cstr = attach_error.GetCString();
+        error.msg = "Failed to attach to " + description + ": " +
+                    (lldb_error_cstr ? lldb_error_cstr : "unknown error");
+        return error;
+    }
+
+    app.sessions.push_back(std::move(session));
+    app.pending_attach = std::move(attach);
+    app.attach_error.clear();
+
+    LOG(Info) << "Attaching to " << description;
 
-    glutSwapBuffers();
-    glutPostRedisplay();
+    return {};
 }
 
-void initialize_rendering(int* argcp, char** argv)
+// Completes or abandons the pending attach of the session once its process stops or exits.
+// Returns whether the event is to be handled like any other, which the session may not outlive.
+bool update_attach(Application& app, TargetSession& session, lldb::SBProcess process, lldb::StateType state)
 {
-    // Create GLUT window
-    glutInit(argcp, argv);
-    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
-    glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_MULTISAMPLE);
-    glutInitWindowSize(1280, 720);
-    glutCreateWindow("lldbg");
+    if (state != lldb::eStateStopped && state != lldb::eStateExited && state != lldb::eStateDetached) {
+        return false;
+    }
 
-    // Setup GLUT display function
-    // We will also call ImGui_ImplFreeGLUT_InstallFuncs() to get all the other functions installed for us,
-    // otherwise it is possible to install our own functions and call the imgui_impl_freeglut.h functions
-    // ourselves.
-    glutDisplayFunc(main_loop);
+    PendingAttach attach = std::move(*app.pending_attach);
+    app.pending_attach.reset();
 
-    // Setup Dear ImGui context
-    ImGui::CreateContext();
-    // ImGuiIO& io = ImGui::GetIO();
-    // io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;  // Enable Keyboard Controls
+    if (state != lldb::eStateStopped || attach.cancelled) {
+        if (attach.cancelled) {
+            if (state == lldb::eStateStopped) {
+                process.Detach();
+            }
+        }
+        else {
+            const char* exit_description = process.GetExitDescription();
+            app.attach_error = "Failed to attach to " + attach.description + ": " +
+                               (exit_description ? exit_description : "the process exited");
+            LOG(Error) << app.attach_error;
+        }
+        delete_session(app, attach.session_id);
+        return false;
+    }
 
-    // Setup Dear ImGui style
-    ImGui::StyleColorsDark();
-    // ImGui::StyleColorsClassic();
+    const double elapsed_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - attach.start).count();
+    LOG(Info) << "Attached to " << attach.description << " after " << elapsed_s << " s";
 
-    // disable all rounding
-    ImGui::GetStyle().WindowRounding = 0.0f;
-    ImGui::GetStyle().ChildRounding = 0.0f;
-    ImGui::GetStyle().FrameRounding = 0.0f;
-    ImGui::GetStyle().GrabRounding = 0.0f;
-    ImGui::GetStyle().PopupRounding = 0.0f;
-    ImGui::GetStyle().ScrollbarRounding = 0.0f;
-    ImGui::GetStyle().TabRounding = 0.0f;
+    select_session(app, session);
+    session.symbols = start_symbol_preload(app, session.target);
 
-    // Setup Platform/Renderer bindings
-    ImGui_ImplFreeGLUT_Init();
-    ImGui_ImplFreeGLUT_InstallFuncs();
-    ImGui_ImplOpenGL2_Init();
-}
+    lldb::SBFileSpec executable = session.target.GetExecutable();
+    if (executable.IsValid() && executable.GetDirectory()) {
+        app.file_browser = FileBrowserNode::create(executable.GetDirectory());
+    }
 
-void cleanup_rendering()
-{
-    ImGui_ImplOpenGL2_Shutdown();
-    ImGui_ImplFreeGLUT_Shutdown();
-    ImGui::DestroyContext();
+    return true;
 }
 
-}  // namespace lldbg
-
-namespace lldbg {
+}  // namespace
 
-Application::Application(int* argcp, char** argv)
+const std::optional<TargetStartError> attach_to_process(Application& app, lldb::pid_t pid)
 {
-    lldb::SBDebugger::Initialize();
-    debugger = lldb::SBDebugger::Create();
-    debugger.SetAsync(true);
-    command_line.replace_interpreter(debugger.GetCommandInterpreter());
-    command_line.run_command("settings set auto-confirm 1", true);
-    command_line.run_command("settings set target.x86-disassembly-flavor intel", true);
-
-    initialize_rendering(argcp, argv);
-
-    text_editor.SetLanguageDefinition(TextEditor::LanguageDefinition::CPlusPlus());
-    TextEditor::Palette pal = text_editor.GetPalette();
-    pal[(int)TextEditor::PaletteIndex::Breakpoint] = ImGui::GetColorU32(ImVec4(255, 0, 0, 255));
-    text_editor.SetPalette(pal);
+    return start_attach(app, lldb::SBAttachInfo(pid), "pid " + std::to_string(pid));
 }
 
-Application::~Application()
+const std::optional<TargetStartError> attach_to_process(Application& app, const std::string& process_name,
+                                                        bool wait_for_launch)
 {
-    event_listener.stop(debugger);
-    lldb::SBDebugger::Terminate();
-    cleanup_rendering();
+    return start_attach(app, lldb::SBAttachInfo(process_name.c_str(), wait_for_launch),
+                        process_name + (wait_for_launch ? " (waiting for launch)" : ""));
 }
 
-const std::optional<TargetStartError> create_new_target(Application& app, const char* exe_filepath,
-                                                        const char** argv, bool delay_start,
-                                                        std::optional<std::string> workdir)
+void cancel_attach(Application& app)
 {
-    if (app.debugger.GetNumTargets() > 0) {
-        TargetStartError error;
-        error.type = TargetStartError::Type::HasTargetAlready;
-        error.msg = "Multiple targets not yet supported by lldbg.";
-        return error;
+    if (!app.pending_attach || app.pending_attach->cancelled) {
+        return;
     }
 
-    const fs::path full_exe_path = fs::canonical(exe_filepath);
+    app.pending_attach->cancelled = true;
+    LOG(Info) << "Cancelled attaching to " << app.pending_attach->description;
 
-    if (!fs::exists(full_exe_path)) {
-        TargetStartError error;
-        error.type = TargetStartError::Type::ExecutableDoesNotExist;
-        error.msg = "Requested executable does not exist: " + full_exe_path.string();
-        return error;
+    TargetSession* session = find_session(app, app.pending_attach->session_id);
+    lldb::SBProcess process = session ? session->target.GetProcess() : lldb::SBProcess();
+    if (!process.IsValid()) {
+        if (session) {
+            delete_session(app, session->id);
+        }
+        app.pending_attach.reset();
+        return;
     }
 
-    // TODO: only set file browser node once we know the process has started successfully
-    if (workdir && fs::exists(*workdir) && fs::is_directory(*workdir)) {
-        app.file_browser = FileBrowserNode::create(*workdir);
-    }
-    else if (full_exe_path.has_parent_path()) {
-        app.file_browser = FileBrowserNode::create(full_exe_path.parent_path());
+    // Interrupts waiting for a launch, the process then stops or exits and update_attach detaches
+    // from it and deletes the session. The inferior itself is left running.
+    if (SB_CALL(Process, process.GetState()) == lldb::eStateAttaching) {
+        process.Stop();
     }
     else {
-        app.file_browser = FileBrowserNode::create(fs::current_path());
-    }
-
-    // TODO: loop through running processes (if any) and kill them and log information about it.
-    lldb::SBError lldb_error;
-    lldb::SBTarget new_target =
-        app.debugger.CreateTarget(full_exe_path.c_str(), nullptr, nullptr, true, lldb_error);
-
-    if (!lldb_error.Success()) {
-        TargetStartError error;
-        error.type = TargetStartError::Type::TargetCreation;
-        const char* lldb_error_cstr = lldb_error.GetCString();
-        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown target creation error!";
-        return error;
+        process.Detach();
     }
+}
 
-    LOG(Debug) << "Succesfully created target for executable: " << full_exe_path;
-
-    lldb::SBLaunchInfo launch_info(argv);
-    launch_info.SetLaunchFlags(lldb::eLaunchFlagDisableASLR | lldb::eLaunchFlagStopAtEntry);
-    lldb::SBProcess process = new_target.Launch(launch_info, lldb_error);
-
-    if (!lldb_error.Success()) {
-        TargetStartError error;
-        error.type = TargetStartError::Type::Launch;
-        const char* lldb_error_cstr = lldb_error.GetCString();
-        error.msg = lldb_error_cstr ? std::string(lldb_error_cstr) : "Unknown target launch error!";
-        LOG(Error) << "Failed to launch process, destroying target...";
-        app.debugger.DeleteTarget(new_target);
-        return error;
+bool wait_for_attach(Application& app, std::chrono::milliseconds timeout)
+{
+    if (!app.pending_attach) {
+        return false;
     }
 
-    LOG(Debug) << "Succesfully launched process for executable: " << full_exe_path;
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const uint32_t session_id = app.pending_attach->session_id;
 
-    size_t ms_attaching = 0;
-    while (process.GetState() == lldb::eStateAttaching) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        ms_attaching += 100;
-        if (ms_attaching / 1000 > 5) {
-            TargetStartError error;
-            error.type = TargetStartError::Type::AttachTimeout;
-            error.msg = "Took more than five seconds to attach to process, gave up!";
-            return error;
+    while (app.pending_attach) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
         }
-    }
-
-    LOG(Debug) << "Succesfully attached to process for executable: " << exe_filepath;
-
-    app.event_listener.start(app.debugger);
 
-    if (!delay_start) {
-        get_process(app).Continue();
+        const std::optional<lldb::SBEvent> event = app.event_listener.wait_event(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+        if (event) {
+            handle_event(app, *event);
+        }
     }
 
-    return {};
+    // a failed or cancelled attach deletes its session, a successful one selects it
+    TargetSession* session = selected_session(app);
+    return session && session->id == session_id;
 }
 
 void continue_process(Application& app)
@@ -804,67 +497,422 @@ void kill_process(Application& app)
     process.Kill();
 }
 
+void step_over(Application& app)
+{
+    lldb::SBThread thread = get_process(app).GetSelectedThread();
+    assert(thread.IsValid());
+    thread.StepOver();
+}
+
+void step_into(Application& app)
+{
+    lldb::SBThread thread = get_process(app).GetSelectedThread();
+    assert(thread.IsValid());
+    thread.StepInto();
+}
+
+void step_out(Application& app)
+{
+    lldb::SBThread thread = get_process(app).GetSelectedThread();
+    assert(thread.IsValid());
+    thread.StepOut();
+}
+
+void queue_steps(Application& app, StepKind kind, uint32_t count)
+{
+    TargetSession* session = selected_session(app);
+    if (!session || count == 0) {
+        return;
+    }
+
+    TargetSession::RapidStep& rapid_step = session->rapid_step;
+    if (rapid_step.in_flight) {
+        if (rapid_step.kind != kind) {
+            rapid_step.queued = 0;
+            rapid_step.kind = kind;
+        }
+        rapid_step.queued += count;
+        return;
+    }
+
+    // running for some other reason, e.g. continued
+    if (!session->stop_snapshot) {
+        return;
+    }
+
+    rapid_step.kind = kind;
+    rapid_step.queued = count - 1;
+    rapid_step.in_flight = true;
+    step(get_process(app).GetSelectedThread(), kind);
+}
+
 lldb::SBProcess get_process(Application& app)
 {
-    assert(app.debugger.GetNumTargets() <= 1);
     return app.debugger.GetSelectedTarget().GetProcess();
 }
 
-void manually_open_and_or_focus_file(Application& app, const char* filepath)
+void delete_session(Application& app, uint32_t session_id)
+{
+    for (auto it = app.sessions.begin(); it != app.sessions.end(); ++it) {
+        if ((*it)->id == session_id) {
+            (*it)->symbols.reset();
+            (*it)->thread_groups.cancel();
+            app.debugger.DeleteTarget((*it)->target);
+            app.sessions.erase(it);
+            return;
+        }
+    }
+}
+
+TargetSession* find_session(Application& app, lldb::SBTarget target)
+{
+    for (std::unique_ptr<TargetSession>& session : app.sessions) {
+        if (session->target == target) {
+            return session.get();
+        }
+    }
+    return nullptr;
+}
+
+TargetSession* selected_session(Application& app)
+{
+    return find_session(app, app.debugger.GetSelectedTarget());
+}
+
+void select_session(Application& app, TargetSession& session)
+{
+    app.debugger.SetSelectedTarget(session.target);
+}
+
+namespace {
+
+// Watchpoint events carry neither a target nor (once deleted) a watchpoint that knows its target,
+// only the target that broadcast them.
+TargetSession* find_broadcasting_session(Application& app, lldb::SBEvent& event)
+{
+    for (std::unique_ptr<TargetSession>& session : app.sessions) {
+        if (event.BroadcasterMatchesRef(session->target.GetBroadcaster())) {
+            return session.get();
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+void handle_event(Application& app, lldb::SBEvent event)
+{
+    if (lldb::SBBreakpoint::EventIsBreakpointEvent(event)) {
+        lldb::SBTarget target = lldb::SBBreakpoint::GetBreakpointFromEvent(event).GetTarget();
+        if (TargetSession* session = find_session(app, target)) {
+            session->breakpoints.Synchronize(target);
+            session->breakpoint_table.synchronize(target);
+        }
+        return;
+    }
+
+    if (lldb::SBWatchpoint::EventIsWatchpointEvent(event)) {
+        if (TargetSession* session = find_broadcasting_session(app, event)) {
+            session->watchpoints.synchronize(session->target);
+        }
+        return;
+    }
+
+    if (!lldb::SBProcess::EventIsProcessEvent(event)) {
+        return;
+    }
+
+    lldb::SBProcess process = lldb::SBProcess::GetProcessFromEvent(event);
+    TargetSession* session = find_session(app, process.GetTarget());
+    if (!session) {
+        return;
+    }
+
+    const lldb::StateType new_state = lldb::SBProcess::GetStateFromEvent(event);
+    const char* state_descr = lldb::SBDebugger::StateAsCString(new_state);
+    LOG(Debug) << "Found event with new state: " << state_descr << " (pid " << process.GetProcessID() << ")";
+
+    if (app.pending_attach && app.pending_attach->session_id == session->id &&
+        !update_attach(app, *session, process, new_state)) {
+        return;
+    }
+
+    switch (new_state) {
+        case lldb::eStateStopped:
+            // the process was automatically resumed (e.g. a breakpoint condition was false)
+            if (lldb::SBProcess::GetRestartedFromEvent(event)) {
+                session->breakpoint_table.record_auto_resume();
+                break;
+            }
+            if (session->rapid_step.in_flight && continue_rapid_step(*session, process)) {
+                break;
+            }
+            session->stop_snapshot = StopSnapshot::build(
+                process, session->is_core, session->previous_snapshot ? &*session->previous_snapshot : nullptr);
+            session->previous_snapshot.reset();
+            retain_frame_variables(*session);
+            // so that the selected thread's registers are diffed against the previous stop
+            session->registers.capture(process, *session->stop_snapshot);
+            session->breakpoint_table.record_stop(process);
+            // hit counts only change while running, and aren't broadcast as watchpoint events
+            session->watchpoints.synchronize(session->target);
+            break;
+        case lldb::eStateRunning:
+        case lldb::eStateStepping:
+            if (session->stop_snapshot) {
+                session->previous_snapshot = std::move(session->stop_snapshot);
+                session->stop_snapshot.reset();
+            }
+            session->breakpoint_table.record_resume();
+            session->memory.invalidate();
+            session->thread_groups.cancel();
+            break;
+        case lldb::eStateExited: {
+            // TODO: make this actually be useful
+            session->stop_snapshot.reset();
+            session->previous_snapshot.reset();
+            session->variables.reset();
+            session->rapid_step = {};
+            lldbg::ExitDialog dialog;
+            dialog.process_name = "asdf";
+            dialog.exit_code = process.GetExitStatus();
+            app.exit_dialog = dialog;
+            LOG(Debug) << "Set exit dialog";
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void process_events(Application& app)
 {
-    if (app.open_files.open(std::string(filepath))) {
-        app.render_state.request_manual_tab_change = true;
+    PROFILE_SCOPE("process events");
+
+    while (std::optional<lldb::SBEvent> event = app.event_listener.pop_event()) {
+        handle_event(app, *event);
     }
 }
 
+bool wait_for_stop(Application& app, std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    TargetSession* session = selected_session(app);
+    if (!session) {
+        return false;
+    }
+
+    while (!session->stop_snapshot && !app.exit_dialog) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+        const std::optional<lldb::SBEvent> event = app.event_listener.wait_event(
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now));
+        if (event) {
+            handle_event(app, *event);
+        }
+    }
+
+    return session->stop_snapshot.has_value();
+}
+
 bool run_lldb_command(Application& app, const char* command)
 {
+    PROFILE_SCOPE("run_lldb_command");
+
     const size_t num_breakpoints_before = app.debugger.GetSelectedTarget().GetNumBreakpoints();
+    const size_t num_watchpoints_before = app.debugger.GetSelectedTarget().GetNumWatchpoints();
 
     const bool command_succeeded = app.command_line.run_command(command);
 
     const size_t num_breakpoints_after = app.debugger.GetSelectedTarget().GetNumBreakpoints();
+    const size_t num_watchpoints_after = app.debugger.GetSelectedTarget().GetNumWatchpoints();
 
-    if (num_breakpoints_before != num_breakpoints_after) {
-        app.breakpoints.Synchronize(app.debugger.GetSelectedTarget());
-
-        const std::optional<FileReference> maybe_ref = app.open_files.focus();
-        if (maybe_ref) {
-            const std::string filepath = (*maybe_ref).canonical_path.string();
-            app.text_editor.SetBreakpoints(app.breakpoints.Get(filepath));
+    // the command may also have selected another target
+    if (TargetSession* session = selected_session(app)) {
+        if (num_breakpoints_before != num_breakpoints_after) {
+            session->breakpoints.Synchronize(session->target);
+            session->breakpoint_table.synchronize(session->target);
+        }
+        // 'watchpoint modify' changes no count, but is broadcast as a watchpoint event
+        if (num_watchpoints_before != num_watchpoints_after) {
+            session->watchpoints.synchronize(session->target);
         }
+
+        // the command may have written to memory (e.g. 'memory write' or an expression)
+        session->memory.invalidate();
+        session->variables.reset();
     }
 
     return command_succeeded;
 }
 
+bool add_breakpoint(Application& app, const std::string& filepath, int line)
+{
+    lldb::SBTarget target = app.debugger.GetSelectedTarget();
+    lldb::SBBreakpoint new_breakpoint = target.BreakpointCreateByLocation(filepath.c_str(), line);
+    if (new_breakpoint.IsValid() && new_breakpoint.GetNumLocations() > 0) {
+        if (TargetSession* session = selected_session(app)) {
+            session->breakpoints.Synchronize(target);
+            session->breakpoint_table.synchronize(target);
+        }
+        return true;
+    }
+    else {
+        LOG(Debug) << "Removing invalid break point";
+        target.BreakpointDelete(new_breakpoint.GetID());
+        return false;
+    }
+}
+
 void add_breakpoint_to_viewed_file(Application& app, int line)
 {
     std::optional<lldbg::FileReference> ref = app.open_files.focus();
     if (ref) {
-        const std::string focus_filepath = (*ref).canonical_path.string();
-        lldb::SBTarget target = app.debugger.GetSelectedTarget();
-        lldb::SBBreakpoint new_breakpoint = target.BreakpointCreateByLocation(focus_filepath.c_str(), line);
-        if (new_breakpoint.IsValid() && new_breakpoint.GetNumLocations() > 0) {
-            app.breakpoints.Synchronize(app.debugger.GetSelectedTarget());
-            app.text_editor.SetBreakpoints(app.breakpoints.Get(focus_filepath));
-        }
-        else {
-            LOG(Debug) << "Removing invalid break point";
-            target.BreakpointDelete(new_breakpoint.GetID());
-        }
+        add_breakpoint(app, (*ref).canonical_path.string(), line);
+    }
+}
+
+namespace {
+
+bool finish_adding_watchpoint(Application& app, lldb::SBWatchpoint watchpoint, const lldb::SBError& error,
+                              const std::string& label, WatchKind kind)
+{
+    if (!error.Success() || !watchpoint.IsValid()) {
+        const char* lldb_error_cstr = error.GetCString();
+        LOG(Warning) << "Failed to watch " << label << ": "
+                     << (lldb_error_cstr ? lldb_error_cstr : "unknown watchpoint error");
+        return false;
+    }
+
+    if (TargetSession* session = selected_session(app)) {
+        session->watchpoints.remember_origin(watchpoint.GetID(), label, kind);
+        session->watchpoints.synchronize(session->target);
     }
+    return true;
+}
+
+void synchronize_watchpoints(Application& app)
+{
+    if (TargetSession* session = selected_session(app)) {
+        session->watchpoints.synchronize(session->target);
+    }
+}
+
+void synchronize_breakpoints(Application& app)
+{
+    if (TargetSession* session = selected_session(app)) {
+        session->breakpoints.Synchronize(session->target);
+        session->breakpoint_table.synchronize(session->target);
+    }
+}
+
+}  // namespace
+
+bool add_watchpoint(Application& app, uint64_t address, size_t size, WatchKind kind)
+{
+    char label[32];
+    snprintf(label, sizeof(label), "0x%llx", (unsigned long long)address);
+
+    const bool read = kind != WatchKind::Write;
+    const bool write = kind != WatchKind::Read;
+
+    lldb::SBTarget target = app.debugger.GetSelectedTarget();
+    lldb::SBError error;
+    lldb::SBWatchpoint watchpoint = SB_CALL(Watchpoint, target.WatchAddress(address, size, read, write, error));
+
+    return finish_adding_watchpoint(app, watchpoint, error, label, kind);
+}
+
+bool add_watchpoint(Application& app, lldb::SBValue value, WatchKind kind)
+{
+    const bool read = kind != WatchKind::Write;
+    const bool write = kind != WatchKind::Read;
+
+    lldb::SBError error;
+    lldb::SBWatchpoint watchpoint = SB_CALL(Watchpoint, value.Watch(true, read, write, error));
+
+    return finish_adding_watchpoint(app, watchpoint, error, build_string(value.GetName()), kind);
+}
+
+void set_watchpoint_enabled(Application& app, lldb::watch_id_t id, bool enabled)
+{
+    lldb::SBWatchpoint watchpoint = SB_CALL(Watchpoint, app.debugger.GetSelectedTarget().FindWatchpointByID(id));
+    if (watchpoint.IsValid()) {
+        SB_CALL(Watchpoint, watchpoint.SetEnabled(enabled));
+        synchronize_watchpoints(app);
+    }
+}
+
+void set_watchpoint_condition(Application& app, lldb::watch_id_t id, const std::string& condition)
+{
+    lldb::SBWatchpoint watchpoint = SB_CALL(Watchpoint, app.debugger.GetSelectedTarget().FindWatchpointByID(id));
+    if (watchpoint.IsValid()) {
+        // an empty condition removes it
+        SB_CALL(Watchpoint, watchpoint.SetCondition(condition.empty() ? nullptr : condition.c_str()));
+        synchronize_watchpoints(app);
+    }
+}
+
+void delete_watchpoint(Application& app, lldb::watch_id_t id)
+{
+    SB_CALL(Watchpoint, app.debugger.GetSelectedTarget().DeleteWatchpoint(id));
+    synchronize_watchpoints(app);
+}
+
+void set_breakpoint_enabled(Application& app, lldb::break_id_t id, bool enabled)
+{
+    lldb::SBBreakpoint breakpoint =
+        SB_CALL(Breakpoint, app.debugger.GetSelectedTarget().FindBreakpointByID(id));
+    if (breakpoint.IsValid()) {
+        SB_CALL(Breakpoint, breakpoint.SetEnabled(enabled));
+        synchronize_breakpoints(app);
+    }
+}
+
+void set_breakpoint_condition(Application& app, lldb::break_id_t id, const std::string& condition)
+{
+    lldb::SBBreakpoint breakpoint =
+        SB_CALL(Breakpoint, app.debugger.GetSelectedTarget().FindBreakpointByID(id));
+    if (breakpoint.IsValid()) {
+        // an empty condition removes it
+        SB_CALL(Breakpoint, breakpoint.SetCondition(condition.empty() ? nullptr : condition.c_str()));
+        synchronize_breakpoints(app);
+    }
+}
+
+void set_breakpoint_ignore_count(Application& app, lldb::break_id_t id, uint32_t ignore_count)
+{
+    lldb::SBBreakpoint breakpoint =
+        SB_CALL(Breakpoint, app.debugger.GetSelectedTarget().FindBreakpointByID(id));
+    if (breakpoint.IsValid()) {
+        SB_CALL(Breakpoint, breakpoint.SetIgnoreCount(ignore_count));
+        synchronize_breakpoints(app);
+    }
+}
+
+void delete_breakpoint(Application& app, lldb::break_id_t id)
+{
+    SB_CALL(Breakpoint, app.debugger.GetSelectedTarget().BreakpointDelete(id));
+    synchronize_breakpoints(app);
 }
 
 void delete_current_targets(Application& app)
 {
-    for (auto i = 0; i < app.debugger.GetNumTargets(); i++) {
-        lldb::SBTarget target = app.debugger.GetTargetAtIndex(i);
+    for (std::unique_ptr<TargetSession>& session : app.sessions) {
+        session->symbols.reset();
+        session->thread_groups.cancel();
+    }
+
+    while (app.debugger.GetNumTargets() > 0) {
+        lldb::SBTarget target = app.debugger.GetTargetAtIndex(0);
         app.debugger.DeleteTarget(target);
     }
+    app.sessions.clear();
 }
 
-std::unique_ptr<Application> g_application = nullptr;
-
 }  // namespace lldbg
 
@@ -2,54 +2,125 @@
 
 #include "lldb/API/LLDB.h"
 
+#include "Breakpoints.hpp"
+#include "Disassembly.hpp"
 #include "FileSystem.hpp"
 #include "Log.hpp"
-#include "TextEditor.h"
+#include "MemoryCache.hpp"
+#include "Registers.hpp"
+#include "StopSnapshot.hpp"
+#include "SymbolPreloader.hpp"
+#include "ThreadGroups.hpp"
+#include "Watchpoints.hpp"
 
 #include "LLDBCommandLine.hpp"
 #include "LLDBEventListenerThread.hpp"
 
 #include <assert.h>
+#include <chrono>
 #include <iostream>
-#include "imgui.h"
+#include <optional>
+#include <vector>
 
 namespace lldbg {
 
-// rename UserInterface?
-struct RenderState {
-    int viewed_thread_index = -1;
-    int viewed_frame_index = -1;
-    int window_width = -1;
-    int window_height = -1;
-    bool request_manual_tab_change = false;
-    bool ran_command_last_frame = false;
-    ImFont* font = nullptr;
-
-    static constexpr float DEFAULT_FILEBROWSER_WIDTH_PERCENT = 0.12;
-    static constexpr float DEFAULT_FILEVIEWER_WIDTH_PERCENT = 0.6;
-    static constexpr float DEFAULT_STACKTRACE_WIDTH_PERCENT = 0.28;
-
-    // TODO: add reset method and call when destroy/reset debug target
-};
-
 struct ExitDialog {
     std::string process_name;
     int exit_code;
 };
 
+enum class StepKind { Over, Into, Out };
+
+// Everything cached about one target and its process. Each target's listener events only ever
+// touch its own session, so several processes (e.g. a client and its server) can be debugged at once.
+struct TargetSession {
+    // The viewed frame's variables, fetched once and kept across stops for as long as the thread's
+    // stack doesn't change (the values themselves are re-read by LLDB after every stop)
+    struct FrameVariables {
+        uint32_t stop_id = 0;
+        uint64_t thread_id = 0;
+        uint32_t frame_index = 0;
+        lldb::SBValueList values;
+    };
+
+    // Steps taken back to back, e.g. while a step key is held down. Intermediate stops only record
+    // where the thread is, the StopSnapshot is built once the last queued step stops.
+    struct RapidStep {
+        StepKind kind = StepKind::Over;
+        uint32_t queued = 0;     // not issued yet
+        bool in_flight = false;  // issued by queue_steps, not stopped yet
+        uint64_t steps_taken = 0;
+        std::optional<FrameSnapshot> location;  // innermost frame of the last stop
+    };
+
+    uint32_t id = 0;  // unique for the lifetime of the Application
+    lldb::SBTarget target;
+
+    // a post-mortem process, whose stacks are only walked when looked at (see StopSnapshot::build)
+    bool is_core = false;
+
+    lldbg::BreakPointSet breakpoints;  // lines marked in the source view
+    lldbg::BreakpointTable breakpoint_table;
+    lldbg::WatchpointTable watchpoints;
+
+    // rebuilt whenever the process stops, empty while it is running
+    std::optional<StopSnapshot> stop_snapshot;
+
+    // the last stop's snapshot while the process runs, diffed against by the next one so that only
+    // the threads which actually ran get their stacks walked again
+    std::optional<StopSnapshot> previous_snapshot;
+
+    // filled lazily, for the frames whose registers are actually looked at
+    RegisterCache registers;
+
+    std::optional<FrameVariables> variables;
+
+    RapidStep rapid_step;
+
+    // inferior memory shown in the Memory pane, only valid while the process stays stopped
+    MemoryCache memory;
+
+    DisassemblyCache disassembly;
+
+    // threads aggregated by stack for the Threads pane, computed in the background once per stop
+    ThreadGrouper thread_groups;
+
+    // declared last so that it is stopped before anything else of the session is destroyed
+    std::unique_ptr<SymbolPreloader> symbols;
+};
+
+// Attaching can take a long time (symbol loading for a huge process, or waiting for a process with
+// a given name to be launched). The debugger is asynchronous, so SBTarget::Attach returns right away
+// and the attach is pending until the process of its session first stops or exits.
+struct PendingAttach {
+    uint32_t session_id = 0;
+    std::string description;
+    std::chrono::steady_clock::time_point start;
+    bool cancelled = false;
+};
+
+// The debugger state, independent of any rendering, so that it can be driven headlessly.
+// See Draw.hpp for the user interface built on top of it.
 struct Application {
     lldb::SBDebugger debugger;
     lldbg::LLDBEventListenerThread event_listener;
     lldbg::LLDBCommandLine command_line;
     lldbg::OpenFiles open_files;
-    lldbg::BreakPointSet breakpoints;
     std::unique_ptr<lldbg::FileBrowserNode> file_browser;
-    RenderState render_state;
-    TextEditor text_editor;
+
+    // one per target, in creation order
+    std::vector<std::unique_ptr<TargetSession>> sessions;
+    uint32_t next_session_id = 1;
+
+    // threads warming up each new target's symbols in the background, 0 to leave it all to LLDB
+    unsigned symbol_preload_threads = SymbolPreloader::default_thread_count();
+
+    std::optional<PendingAttach> pending_attach;
+    std::string attach_error;  // of the last failed attach
 
     std::optional<ExitDialog> exit_dialog;
 
-    Application(int* argcp, char** argv);
+    Application();
     ~Application();
 
     Application(const Application&) = delete;
@@ -57,19 +128,14 @@ struct Application {
     Application& operator=(Application&&) = delete;
 };
 
-// We only use a global variable because of how freeglut
-// requires a frame update function with signature void(void).
-// It is not used anywhere other than main_loop from main.cpp
-extern std::unique_ptr<Application> g_application;
-
 struct TargetStartError {
     std::string msg = "Unknown error!";
     enum class Type {
         ExecutableDoesNotExist,
         TargetCreation,
         Launch,
-        AttachTimeout,
-        HasTargetAlready,
+        Attach,
+        LoadCore,
         Unknown
     } type = Type::Unknown;
 };
@@ -78,16 +144,56 @@ const std::optional<TargetStartError> create_new_target(Application& app, const
                                                         const char** argv, bool delay_start = true,
                                                         std::optional<std::string> workdir = {});
 void delete_current_targets(Application& app);
+
+// Post-mortem debugging of a core dump of the given executable
+const std::optional<TargetStartError> open_core_file(Application& app, const char* exe_filepath,
+                                                     const char* core_filepath);
+
+// The variables of a frame of the session's stopped process, cached until the next stop
+lldb::SBValueList frame_variables(TargetSession& session, size_t thread_index, uint32_t frame_index);
+
+// Attaching only starts here, it completes when handle_event sees the process stop
+const std::optional<TargetStartError> attach_to_process(Application& app, lldb::pid_t pid);
+const std::optional<TargetStartError> attach_to_process(Application& app, const std::string& process_name,
+                                                        bool wait_for_launch);
+void cancel_attach(Application& app);
+// whether the pending attach succeeded in time, false when it failed or was cancelled
+bool wait_for_attach(Application& app, std::chrono::milliseconds timeout);
 void kill_process(Application& app);
 void pause_process(Application& app);
 void continue_process(Application& app);
+void step_over(Application& app);
+void step_into(Application& app);
+void step_out(Application& app);
+
+// Steps the selected thread count times without building a StopSnapshot in between. Queueing
+// more steps while stepping extends the run, stepping ends early at anything but a completed step.
+void queue_steps(Application& app, StepKind kind, uint32_t count);
 void handle_event(Application& app, lldb::SBEvent);
-void manually_open_and_or_focus_file(Application& app, const char* filepath);
+void process_events(Application& app);
+bool wait_for_stop(Application& app, std::chrono::milliseconds timeout);
 bool run_lldb_command(Application& app, const char* command);
+bool add_breakpoint(Application& app, const std::string& filepath, int line);
 void add_breakpoint_to_viewed_file(Application& app, int line);
+bool add_watchpoint(Application& app, uint64_t address, size_t size, WatchKind kind);
+bool add_watchpoint(Application& app, lldb::SBValue value, WatchKind kind);
+void set_watchpoint_enabled(Application& app, lldb::watch_id_t id, bool enabled);
+void set_watchpoint_condition(Application& app, lldb::watch_id_t id, const std::string& condition);
+void delete_watchpoint(Application& app, lldb::watch_id_t id);
+void set_breakpoint_enabled(Application& app, lldb::break_id_t id, bool enabled);
+void set_breakpoint_condition(Application& app, lldb::break_id_t id, const std::string& condition);
+void set_breakpoint_ignore_count(Application& app, lldb::break_id_t id, uint32_t ignore_count);
+void delete_breakpoint(Application& app, lldb::break_id_t id);
 
 // void reset(Application& app);
 
 lldb::SBProcess get_process(Application& app);
 
+// The session of the debugger's selected target, which the UI and all commands act on
+TargetSession* selected_session(Application& app);
+TargetSession* find_session(Application& app, lldb::SBTarget target);
+void select_session(Application& app, TargetSession& session);
+// Stops the session's background work and deletes its target, leaving any process as it is
+void delete_session(Application& app, uint32_t session_id);
+
 }  // namespace lldbg
@@ -0,0 +1,164 @@
+#include "Breakpoints.hpp"
+
+#include "Prelude.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+}  // namespace
+
+namespace lldbg {
+
+void BreakpointTable::synchronize(lldb::SBTarget target)
+{
+    PROFILE_SCOPE("BreakpointTable::synchronize");
+
+    std::vector<BreakpointDescription> breakpoints;
+    std::unordered_set<lldb::break_id_t> live_ids;
+
+    const uint32_t num_breakpoints = target.IsValid() ? SB_CALL(Breakpoint, target.GetNumBreakpoints()) : 0;
+    breakpoints.reserve(num_breakpoints);
+
+    for (uint32_t i = 0; i < num_breakpoints; i++) {
+        lldb::SBBreakpoint breakpoint = SB_CALL(Breakpoint, target.GetBreakpointAtIndex(i));
+        if (!breakpoint.IsValid()) {
+            continue;
+        }
+
+        BreakpointDescription description;
+        description.id = SB_CALL(Breakpoint, breakpoint.GetID());
+        description.num_locations = SB_CALL(Breakpoint, breakpoint.GetNumLocations());
+        description.enabled = SB_CALL(Breakpoint, breakpoint.IsEnabled());
+        description.hit_count = SB_CALL(Breakpoint, breakpoint.GetHitCount());
+        description.ignore_count = SB_CALL(Breakpoint, breakpoint.GetIgnoreCount());
+        description.condition = build_string(SB_CALL(Breakpoint, breakpoint.GetCondition()));
+
+        if (description.num_locations > 0) {
+            lldb::SBBreakpointLocation location = SB_CALL(Breakpoint, breakpoint.GetLocationAtIndex(0));
+            lldb::SBLineEntry line_entry = SB_CALL(LineEntry, location.GetAddress().GetLineEntry());
+            if (line_entry.IsValid()) {
+                description.file_name = build_string(SB_CALL(LineEntry, line_entry.GetFileSpec().GetFilename()));
+                description.directory = build_string(SB_CALL(LineEntry, line_entry.GetFileSpec().GetDirectory()));
+                description.directory.append("/");  // FIXME: not cross-platform
+                description.line = (int)line_entry.GetLine();
+            }
+        }
+
+        live_ids.insert(description.id);
+        breakpoints.push_back(std::move(description));
+    }
+
+    for (auto it = m_statistics.begin(); it != m_statistics.end();) {
+        if (live_ids.count(it->first) == 0) {
+            it = m_statistics.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    m_breakpoints = std::move(breakpoints);
+    apply_statistics();
+}
+
+void BreakpointTable::record_stop(lldb::SBProcess process)
+{
+    PROFILE_SCOPE("BreakpointTable::record_stop");
+
+    const auto now = std::chrono::steady_clock::now();
+
+    m_stopped_at.clear();
+    const uint32_t num_threads = SB_CALL(Process, process.GetNumThreads());
+    for (uint32_t i = 0; i < num_threads; i++) {
+        lldb::SBThread thread = SB_CALL(Thread, process.GetThreadAtIndex(i));
+        if (SB_CALL(Thread, thread.GetStopReason()) != lldb::eStopReasonBreakpoint) {
+            continue;
+        }
+
+        // pairs of breakpoint and location ids, one for each breakpoint at the stop address
+        const size_t data_count = SB_CALL(Thread, thread.GetStopReasonDataCount());
+        for (uint32_t j = 0; j + 1 < data_count; j += 2) {
+            const lldb::break_id_t id = (lldb::break_id_t)SB_CALL(Thread, thread.GetStopReasonDataAtIndex(j));
+            if (std::find(m_stopped_at.begin(), m_stopped_at.end(), id) == m_stopped_at.end()) {
+                m_stopped_at.push_back(id);
+                m_statistics[id].stops++;
+            }
+        }
+    }
+    m_stopped_since = now;
+
+    synchronize(process.GetTarget());
+
+    if (m_resumed_at) {
+        const double run_seconds = (double)elapsed_ns(*m_resumed_at, now) / 1e9;
+        for (const BreakpointDescription& breakpoint : m_breakpoints) {
+            Statistics& statistics = m_statistics[breakpoint.id];
+            const uint32_t hits = breakpoint.hit_count - std::min(breakpoint.hit_count, statistics.hit_count_at_resume);
+            statistics.hits_per_second = run_seconds > 0 ? (double)hits / run_seconds : 0;
+        }
+        m_auto_resumes_per_second =
+            run_seconds > 0 ? (double)(m_auto_resumes - m_auto_resumes_at_resume) / run_seconds : 0;
+        apply_statistics();
+    }
+}
+
+void BreakpointTable::record_resume()
+{
+    // also called for the steps queued by queue_steps, whose stops aren't recorded
+    if (!m_stopped_since) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t stopped_ns = elapsed_ns(*m_stopped_since, now);
+    for (lldb::break_id_t id : m_stopped_at) {
+        m_statistics[id].stopped_ns += stopped_ns;
+    }
+    m_stopped_at.clear();
+    m_stopped_since.reset();
+
+    for (const BreakpointDescription& breakpoint : m_breakpoints) {
+        m_statistics[breakpoint.id].hit_count_at_resume = breakpoint.hit_count;
+    }
+    m_auto_resumes_at_resume = m_auto_resumes;
+    m_resumed_at = now;
+
+    apply_statistics();
+}
+
+void BreakpointTable::clear()
+{
+    m_breakpoints.clear();
+    m_statistics.clear();
+    m_stopped_at.clear();
+    m_stopped_since.reset();
+    m_resumed_at.reset();
+    m_auto_resumes = 0;
+    m_auto_resumes_at_resume = 0;
+    m_auto_resumes_per_second = 0;
+    m_version++;
+}
+
+void BreakpointTable::apply_statistics()
+{
+    for (BreakpointDescription& breakpoint : m_breakpoints) {
+        auto it = m_statistics.find(breakpoint.id);
+        if (it != m_statistics.end()) {
+            breakpoint.stops = it->second.stops;
+            breakpoint.stopped_ns = it->second.stopped_ns;
+            breakpoint.hits_per_second = it->second.hits_per_second;
+        }
+    }
+    m_version++;
+}
+
+}  // namespace lldbg
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lldbg {
+
+struct BreakpointDescription {
+    lldb::break_id_t id = 0;
+    std::string file_name;  // of the first location, empty when it has no line entry
+    std::string directory;  // with a trailing slash
+    int line = -1;
+    size_t num_locations = 0;
+    bool enabled = false;
+    uint32_t hit_count = 0;
+    uint32_t ignore_count = 0;
+    std::string condition;
+
+    // measured by lldbg from process events, not known to LLDB
+    uint64_t stops = 0;          // stops that were not automatically resumed
+    uint64_t stopped_ns = 0;     // time spent stopped here, summed over all stops
+    double hits_per_second = 0;  // over the last run of the process
+};
+
+// The target's breakpoints, copied out of LLDB when they change (breakpoint events) and when the
+// process stops (hit counts), along with how often and for how long each one stopped the process.
+// A breakpoint whose condition is mostly false costs a stop and an automatic resume per hit, which
+// is what makes hot loops slow to debug: the hit rates and automatic resumes point it out.
+class BreakpointTable final {
+    struct Statistics {
+        uint64_t stops = 0;
+        uint64_t stopped_ns = 0;
+        uint32_t hit_count_at_resume = 0;
+        double hits_per_second = 0;
+    };
+
+    std::vector<BreakpointDescription> m_breakpoints;
+    std::unordered_map<lldb::break_id_t, Statistics> m_statistics;
+
+    // the breakpoints the process is stopped at, and since when
+    std::vector<lldb::break_id_t> m_stopped_at;
+    std::optional<std::chrono::steady_clock::time_point> m_stopped_since;
+
+    std::optional<std::chrono::steady_clock::time_point> m_resumed_at;
+    uint64_t m_auto_resumes = 0;
+    uint64_t m_auto_resumes_at_resume = 0;
+    double m_auto_resumes_per_second = 0;
+
+    uint64_t m_version = 0;
+
+    void apply_statistics();
+
+public:
+    void synchronize(lldb::SBTarget target);
+
+    // For every stop the process wasn't automatically resumed from, also synchronizes the table
+    void record_stop(lldb::SBProcess process);
+    void record_resume();
+    // a stop the process was resumed from without the user seeing it, e.g. a false condition
+    void record_auto_resume() { m_auto_resumes++; }
+
+    void clear();
+
+    const std::vector<BreakpointDescription>& breakpoints() const { return m_breakpoints; }
+    uint64_t auto_resumes() const { return m_auto_resumes; }
+    double auto_resumes_per_second() const { return m_auto_resumes_per_second; }  // over the last run
+
+    // incremented on every change of the table, including its statistics
+    uint64_t version() const { return m_version; }
+};
+
+}  // namespace lldbg
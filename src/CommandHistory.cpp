@@ -0,0 +1,269 @@
+#include "CommandHistory.hpp"
+
+#include "Log.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+// FNV-1a, used to give each project a stable history file name
+uint64_t hash_path(const std::string& path)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : path) {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+char to_lower(char c) { return (char)std::tolower((unsigned char)c); }
+
+uint32_t trigram_at(const char* s)
+{
+    return ((uint32_t)(uint8_t)to_lower(s[0]) << 16) | ((uint32_t)(uint8_t)to_lower(s[1]) << 8) |
+           (uint32_t)(uint8_t)to_lower(s[2]);
+}
+
+void collect_trigrams(const std::string& text, std::vector<uint32_t>& trigrams)
+{
+    for (size_t i = 0; i + 3 <= text.size(); i++) {
+        trigrams.push_back(trigram_at(text.data() + i));
+    }
+}
+
+bool contains_ignoring_case(const std::string& haystack, const std::string& lowercase_needle)
+{
+    return std::search(haystack.begin(), haystack.end(), lowercase_needle.begin(), lowercase_needle.end(),
+                       [](char a, char b) { return to_lower(a) == b; }) != haystack.end();
+}
+
+// Each record in the log is '<kind> <length>\n<bytes>\n', where kind is 'C' for a command
+// and 'O' for the output excerpt of the command preceding it.
+void append_record(std::ofstream& log, char kind, const std::string& text)
+{
+    log << kind << ' ' << text.size() << '\n';
+    log.write(text.data(), text.size());
+    log << '\n';
+}
+
+}  // namespace
+
+namespace lldbg {
+
+void CommandHistory::open_project(const std::filesystem::path& project_directory)
+{
+    const char* home = getenv("HOME");
+
+    std::optional<std::filesystem::path> new_log_path;
+    if (home) {
+        char filename[32];
+        snprintf(filename, sizeof(filename), "%016llx.log",
+                 (unsigned long long)hash_path(project_directory.string()));
+        new_log_path = std::filesystem::path(home) / ".lldbg" / "history" / filename;
+    }
+
+    if (new_log_path == m_log_path) {
+        return;
+    }
+
+    m_log_path = new_log_path;
+    m_loaded = false;
+    m_entries.clear();
+    m_trigrams.clear();
+    m_cursor = 0;
+
+    LOG(Debug) << "Using command history log for project " << project_directory << ": "
+               << (m_log_path ? m_log_path->string() : std::string("none"));
+}
+
+void CommandHistory::ensure_loaded()
+{
+    if (m_loaded) {
+        return;
+    }
+
+    m_loaded = true;
+
+    if (!m_log_path) {
+        return;
+    }
+
+    Timer timer;
+
+    std::ifstream log(*m_log_path, std::ios::binary);
+
+    char kind;
+    size_t length;
+    while (log >> kind >> length && log.get() == '\n') {
+        std::string text(length, '\0');
+        if (!log.read(&text[0], length) || log.get() != '\n') {
+            LOG(Warning) << "Truncated record in command history log: " << *m_log_path;
+            break;
+        }
+
+        if (kind == 'C') {
+            m_entries.push_back({std::move(text), std::string()});
+        }
+        else if (kind == 'O' && !m_entries.empty()) {
+            m_entries.back().output_excerpt = std::move(text);
+        }
+    }
+
+    for (uint32_t id = 0; id < m_entries.size(); id++) {
+        index_entry(id);
+    }
+
+    reset_cursor();
+
+    LOG(Debug) << "Loaded " << m_entries.size() << " command history entries in "
+               << timer.elapsed_ns() / 1000 << "us";
+}
+
+void CommandHistory::index_entry(uint32_t id)
+{
+    const CommandHistoryEntry& entry = m_entries[id];
+
+    std::vector<uint32_t> trigrams;
+    collect_trigrams(entry.command, trigrams);
+    collect_trigrams(entry.output_excerpt, trigrams);
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    // ids are indexed in increasing order, so every posting list stays sorted
+    for (const uint32_t trigram : trigrams) {
+        m_trigrams[trigram].push_back(id);
+    }
+}
+
+bool CommandHistory::entry_matches(uint32_t id, const std::string& lowercase_query) const
+{
+    const CommandHistoryEntry& entry = m_entries[id];
+    return contains_ignoring_case(entry.command, lowercase_query) ||
+           contains_ignoring_case(entry.output_excerpt, lowercase_query);
+}
+
+void CommandHistory::record(const std::string& command, const std::string& output_excerpt)
+{
+    const std::string excerpt = output_excerpt.substr(0, MAX_OUTPUT_EXCERPT);
+
+    if (m_log_path) {
+        std::error_code ec;
+        std::filesystem::create_directories(m_log_path->parent_path(), ec);
+
+        std::ofstream log(*m_log_path, std::ios::binary | std::ios::app);
+        if (log) {
+            append_record(log, 'C', command);
+            if (!excerpt.empty()) {
+                append_record(log, 'O', excerpt);
+            }
+        }
+        else {
+            LOG(Warning) << "Failed to append to command history log: " << *m_log_path;
+        }
+    }
+
+    // if the log hasn't been read yet, the new entry will be picked up when it is
+    if (m_loaded || !m_log_path) {
+        m_loaded = true;
+        m_entries.push_back({command, excerpt});
+        index_entry((uint32_t)m_entries.size() - 1);
+    }
+
+    reset_cursor();
+}
+
+std::optional<std::string> CommandHistory::previous()
+{
+    ensure_loaded();
+
+    if (m_entries.empty()) {
+        return {};
+    }
+
+    if (m_cursor > 0) {
+        m_cursor--;
+    }
+
+    return m_entries[m_cursor].command;
+}
+
+std::optional<std::string> CommandHistory::next()
+{
+    ensure_loaded();
+
+    if (m_cursor >= m_entries.size()) {
+        return {};
+    }
+
+    m_cursor++;
+
+    if (m_cursor == m_entries.size()) {
+        return std::string();
+    }
+
+    return m_entries[m_cursor].command;
+}
+
+std::optional<size_t> CommandHistory::search(const std::string& query, std::optional<size_t> older_than)
+{
+    ensure_loaded();
+
+    const size_t end = older_than ? std::min(*older_than, m_entries.size()) : m_entries.size();
+
+    if (query.empty() || end == 0) {
+        return {};
+    }
+
+    std::string lowercase_query = query;
+    std::transform(lowercase_query.begin(), lowercase_query.end(), lowercase_query.begin(), to_lower);
+
+    if (lowercase_query.size() < 3) {
+        for (size_t id = end; id-- > 0;) {
+            if (entry_matches((uint32_t)id, lowercase_query)) {
+                return id;
+            }
+        }
+        return {};
+    }
+
+    std::vector<const std::vector<uint32_t>*> postings;
+    for (size_t i = 0; i + 3 <= lowercase_query.size(); i++) {
+        auto it = m_trigrams.find(trigram_at(lowercase_query.data() + i));
+        if (it == m_trigrams.end()) {
+            return {};
+        }
+        postings.push_back(&it->second);
+    }
+
+    std::sort(postings.begin(), postings.end(),
+              [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+    // walk the rarest trigram's posting list backwards, newest first
+    const std::vector<uint32_t>& rarest = *postings.front();
+    auto it = std::lower_bound(rarest.begin(), rarest.end(), (uint32_t)end);
+
+    while (it != rarest.begin()) {
+        --it;
+        const uint32_t id = *it;
+
+        const bool has_all_trigrams =
+            std::all_of(postings.begin() + 1, postings.end(), [id](const std::vector<uint32_t>* list) {
+                return std::binary_search(list->begin(), list->end(), id);
+            });
+
+        // trigrams only narrow down candidates, they don't guarantee the query is contiguous
+        if (has_all_trigrams && entry_matches(id, lowercase_query)) {
+            return id;
+        }
+    }
+
+    return {};
+}
+
+}  // namespace lldbg
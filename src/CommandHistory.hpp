@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lldbg {
+
+struct CommandHistoryEntry {
+    std::string command;
+    std::string output_excerpt;
+};
+
+// The commands entered in all previous sessions for one project, persisted to an append-only
+// log in ~/.lldbg/history/. The log is only read from disk the first time it is needed (for
+// arrow-key recall or reverse search), at which point a trigram index is built over both
+// commands and output excerpts so that searching tens of thousands of entries is instant.
+class CommandHistory final {
+    std::optional<std::filesystem::path> m_log_path;
+    bool m_loaded = false;
+
+    std::vector<CommandHistoryEntry> m_entries;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> m_trigrams;
+    size_t m_cursor = 0;
+
+    void ensure_loaded();
+    void index_entry(uint32_t id);
+    bool entry_matches(uint32_t id, const std::string& lowercase_query) const;
+
+public:
+    // Output is only kept (and indexed) up to this many bytes per command
+    static constexpr size_t MAX_OUTPUT_EXCERPT = 256;
+
+    void open_project(const std::filesystem::path& project_directory);
+    void record(const std::string& command, const std::string& output_excerpt);
+
+    // Arrow-key recall, starting from the most recently recorded command
+    std::optional<std::string> previous();
+    std::optional<std::string> next();
+    void reset_cursor() { m_cursor = m_entries.size(); }
+
+    // Finds the most recent entry older than 'older_than' (or the newest entry overall) whose
+    // command or output excerpt contains the query, ignoring case.
+    std::optional<size_t> search(const std::string& query, std::optional<size_t> older_than = {});
+
+    size_t size() const { return m_entries.size(); }
+    const CommandHistoryEntry& operator[](size_t index) const { return m_entries[index]; }
+};
+
+}  // namespace lldbg
@@ -0,0 +1,180 @@
+#include "Disassembly.hpp"
+
+#include "FileSystem.hpp"
+#include "Prelude.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+// matches the target.x86-disassembly-flavor setting made in Application::Application
+constexpr const char* DISASSEMBLY_FLAVOR = "intel";
+
+std::string format_instruction(uint64_t address, uint64_t start, const char* mnemonic, const char* operands,
+                               const char* comment)
+{
+    char text[512];
+    int length = snprintf(text, sizeof(text), "0x%016llx <+%llu>  %-8s %s", (unsigned long long)address,
+                          (unsigned long long)(address - start), mnemonic ? mnemonic : "",
+                          operands ? operands : "");
+
+    if (comment && comment[0] != '\0' && length > 0 && (size_t)length < sizeof(text)) {
+        snprintf(text + length, sizeof(text) - length, "  ; %s", comment);
+    }
+
+    return text;
+}
+
+}  // namespace
+
+namespace lldbg {
+
+size_t DisassembledFunction::instruction_index(uint64_t address) const
+{
+    auto it = std::upper_bound(instructions.begin(), instructions.end(), address,
+                               [](uint64_t a, const DisassembledInstruction& b) { return a < b.address; });
+    return it == instructions.begin() ? 0 : (size_t)(it - instructions.begin()) - 1;
+}
+
+const std::vector<std::string>& DisassemblyCache::source_lines(const std::string& path)
+{
+    auto it = m_sources.find(path);
+    if (it == m_sources.end()) {
+        std::error_code error;
+        it = m_sources
+                 .emplace(path, std::filesystem::is_regular_file(path, error) ? read_lines(path)
+                                                                              : std::vector<std::string>())
+                 .first;
+    }
+    return it->second;
+}
+
+DisassembledFunction DisassemblyCache::decode(lldb::SBTarget target, uint64_t address)
+{
+    PROFILE_SCOPE("DisassemblyCache::decode");
+
+    DisassembledFunction function;
+    function.start = address;
+
+    lldb::SBAddress sb_address = SB_CALL(Disassembly, target.ResolveLoadAddress(address));
+    lldb::SBFunction sb_function = SB_CALL(Disassembly, sb_address.GetFunction());
+    lldb::SBSymbol symbol = SB_CALL(Disassembly, sb_address.GetSymbol());
+    lldb::SBInstructionList instructions;
+
+    if (sb_function.IsValid()) {
+        function.name = build_string(sb_function.GetDisplayName());
+        lldb::SBAddress start = sb_function.GetStartAddress();
+        function.start = start.GetLoadAddress(target);
+        function.end = sb_function.GetEndAddress().GetLoadAddress(target);
+        instructions =
+            SB_CALL(Disassembly, target.ReadInstructions(start, sb_function.GetEndAddress(), DISASSEMBLY_FLAVOR));
+    }
+    else if (symbol.IsValid()) {
+        function.name = build_string(symbol.GetDisplayName());
+        lldb::SBAddress start = symbol.GetStartAddress();
+        function.start = start.GetLoadAddress(target);
+        function.end = symbol.GetEndAddress().GetLoadAddress(target);
+        instructions = SB_CALL(Disassembly, target.ReadInstructions(start, symbol.GetEndAddress(), DISASSEMBLY_FLAVOR));
+    }
+    else {
+        function.name = "???";
+        instructions = SB_CALL(Disassembly, target.ReadInstructions(sb_address, UNKNOWN_FUNCTION_INSTRUCTIONS,
+                                                                    DISASSEMBLY_FLAVOR));
+    }
+
+    const size_t num_instructions = SB_CALL(Disassembly, instructions.GetSize());
+    function.instructions.reserve(num_instructions);
+
+    for (size_t i = 0; i < num_instructions; i++) {
+        lldb::SBInstruction instruction = SB_CALL(Disassembly, instructions.GetInstructionAtIndex((uint32_t)i));
+        lldb::SBAddress instruction_address = SB_CALL(Disassembly, instruction.GetAddress());
+
+        DisassembledInstruction decoded;
+        decoded.address = instruction_address.GetLoadAddress(target);
+        decoded.text = format_instruction(decoded.address, function.start,
+                                          SB_CALL(Disassembly, instruction.GetMnemonic(target)),
+                                          SB_CALL(Disassembly, instruction.GetOperands(target)),
+                                          SB_CALL(Disassembly, instruction.GetComment(target)));
+
+        lldb::SBLineEntry line_entry = SB_CALL(LineEntry, instruction_address.GetLineEntry());
+        if (line_entry.IsValid() && line_entry.GetLine() > 0) {
+            char path[4096];
+            line_entry.GetFileSpec().GetPath(path, sizeof(path));
+
+            auto file = std::find(function.files.begin(), function.files.end(), path);
+            decoded.file = (int)(file - function.files.begin());
+            if (file == function.files.end()) {
+                function.files.push_back(path);
+            }
+            decoded.line = (int)line_entry.GetLine();
+        }
+
+        // the end of code without symbols is wherever decoding stopped
+        if (!sb_function.IsValid() && !symbol.IsValid()) {
+            function.end = decoded.address + SB_CALL(Disassembly, instruction.GetByteSize());
+        }
+
+        function.instructions.push_back(std::move(decoded));
+    }
+
+    // never empty, so that a failed decode is cached rather than retried every frame
+    function.end = std::max(function.end, address + 1);
+
+    int previous_file = -1;
+    int previous_line = -1;
+    for (size_t i = 0; i < function.instructions.size(); i++) {
+        const DisassembledInstruction& instruction = function.instructions[i];
+
+        if (instruction.line >= 0 && (instruction.file != previous_file || instruction.line != previous_line)) {
+            const std::string& path = function.files[instruction.file];
+            const std::vector<std::string>& lines = source_lines(path);
+
+            MixedRow row;
+            row.instruction = i;
+            row.is_source = true;
+            row.source = std::filesystem::path(path).filename().string() + ":" + std::to_string(instruction.line);
+            if ((size_t)instruction.line <= lines.size()) {
+                row.source += "    " + lines[instruction.line - 1];
+            }
+            function.mixed.push_back(std::move(row));
+
+            previous_file = instruction.file;
+            previous_line = instruction.line;
+        }
+
+        MixedRow row;
+        row.instruction = i;
+        function.mixed.push_back(std::move(row));
+    }
+
+    return function;
+}
+
+const DisassembledFunction& DisassemblyCache::get(lldb::SBTarget target, uint64_t address)
+{
+    for (auto it = m_functions.begin(); it != m_functions.end(); ++it) {
+        if (it->contains(address)) {
+            m_functions.splice(m_functions.begin(), m_functions, it);
+            return m_functions.front();
+        }
+    }
+
+    m_functions.push_front(decode(target, address));
+    if (m_functions.size() > MAX_FUNCTIONS) {
+        m_functions.pop_back();
+    }
+
+    return m_functions.front();
+}
+
+void DisassemblyCache::clear()
+{
+    m_functions.clear();
+    m_sources.clear();
+}
+
+}  // namespace lldbg
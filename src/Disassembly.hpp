@@ -0,0 +1,61 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lldbg {
+
+struct DisassembledInstruction {
+    uint64_t address = 0;
+    std::string text;  // address, offset, mnemonic, operands and comment
+    int file = -1;     // into DisassembledFunction::files
+    int line = -1;
+};
+
+// A row of the mixed source/assembly listing
+struct MixedRow {
+    size_t instruction = 0;
+    bool is_source = false;
+    std::string source;  // the source line that the following instructions were generated from
+};
+
+struct DisassembledFunction {
+    std::string name;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    std::vector<DisassembledInstruction> instructions;  // sorted by address
+    std::vector<std::string> files;
+    std::vector<MixedRow> mixed;
+
+    bool contains(uint64_t address) const { return address >= start && address < end; }
+
+    // The instruction containing the address, or the last one before it
+    size_t instruction_index(uint64_t address) const;
+};
+
+// Decoding a function takes a ReadInstructions call plus several SB calls per instruction, so
+// every function is decoded once, with its address to line mapping and mixed listing, and the
+// most recently viewed MAX_FUNCTIONS are kept.
+class DisassemblyCache final {
+    static constexpr size_t MAX_FUNCTIONS = 64;
+
+    // Code without symbols is decoded in blocks of this many instructions starting at the pc
+    static constexpr uint32_t UNKNOWN_FUNCTION_INSTRUCTIONS = 256;
+
+    std::list<DisassembledFunction> m_functions;  // most recently used first
+    std::unordered_map<std::string, std::vector<std::string>> m_sources;
+
+    DisassembledFunction decode(lldb::SBTarget target, uint64_t address);
+    const std::vector<std::string>& source_lines(const std::string& path);
+
+public:
+    const DisassembledFunction& get(lldb::SBTarget target, uint64_t address);
+    void clear();
+};
+
+}  // namespace lldbg
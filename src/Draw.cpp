@@ -0,0 +1,1879 @@
+#include "Draw.hpp"
+
+#include "Defer.hpp"
+#include "Log.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+#include "Startup.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <cfloat>
+#include <cstdlib>
+#include <filesystem>
+
+#include <GL/freeglut.h>
+#include <imgui_internal.h>
+#include "examples/imgui_impl_freeglut.h"
+#include "examples/imgui_impl_opengl2.h"
+#include "imgui.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool MyTreeNode(const char* label)
+{
+    ImGuiContext& g = *GImGui;
+    ImGuiWindow* window = g.CurrentWindow;
+
+    ImGuiID id = window->GetID(label);
+    ImVec2 pos = window->DC.CursorPos;
+    ImRect bb(pos, ImVec2(pos.x + ImGui::GetContentRegionAvail().x,
+                          pos.y + g.FontSize + g.Style.FramePadding.y * 2));
+    bool opened = ImGui::TreeNodeBehaviorIsOpen(id);
+    bool hovered, held;
+    if (ImGui::ButtonBehavior(bb, id, &hovered, &held, true))
+        window->DC.StateStorage->SetInt(id, opened ? 0 : 1);
+    if (hovered || held)
+        window->DrawList->AddRectFilled(
+            bb.Min, bb.Max, ImGui::GetColorU32(held ? ImGuiCol_HeaderActive : ImGuiCol_HeaderHovered));
+
+    // Icon, text
+    float button_sz = g.FontSize + g.Style.FramePadding.y * 2;
+    // TODO: set colors from style?
+    window->DrawList->AddRectFilled(pos, ImVec2(pos.x + button_sz, pos.y + button_sz),
+                                    opened ? ImColor(51, 105, 173) : ImColor(42, 79, 130));
+    ImGui::RenderText(ImVec2(pos.x + button_sz + g.Style.ItemInnerSpacing.x, pos.y + g.Style.FramePadding.y),
+                      label);
+
+    ImGui::ItemSize(bb, g.Style.FramePadding.y);
+    ImGui::ItemAdd(bb, id);
+
+    if (opened) ImGui::TreePush(label);
+    return opened;
+}
+
+bool Splitter(const char* name, bool split_vertically, float thickness, float* size1, float* size2,
+              float min_size1, float min_size2, float splitter_long_axis_size)
+{
+    using namespace ImGui;
+    ImGuiContext& g = *GImGui;
+    ImGuiWindow* window = g.CurrentWindow;
+    ImGuiID id = window->GetID(name);
+    ImRect bb;
+    bb.Min = window->DC.CursorPos + (split_vertically ? ImVec2(*size1, 0.0f) : ImVec2(0.0f, *size1));
+    bb.Max = bb.Min + CalcItemSize(split_vertically ? ImVec2(thickness, splitter_long_axis_size)
+                                                    : ImVec2(splitter_long_axis_size, thickness),
+                                   0.0f, 0.0f);
+    return SplitterBehavior(bb, id, split_vertically ? ImGuiAxis_X : ImGuiAxis_Y, size1, size2, min_size1,
+                            min_size2, 0.0f);
+}
+
+// the breakpoints of the selected target in a file
+std::unordered_set<int> breakpoint_lines(lldbg::Application& app, const std::string& path)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    return session ? session->breakpoints.Get(path) : std::unordered_set<int>();
+}
+
+// The tooltips of the annotated lines, the text editor only looks up the lines it draws
+TextEditor::ErrorMarkers annotation_markers(const lldbg::LineAnnotationCache& annotations)
+{
+    PROFILE_SCOPE("annotation_markers");
+
+    TextEditor::ErrorMarkers markers;
+    for (const lldbg::LineAnnotation& annotation : annotations.annotations()) {
+        std::string text;
+        if (annotation.viewed_frame) {
+            text += "viewed frame\n";
+        }
+
+        // thousands of threads can be parked on the same line
+        const size_t MAX_LISTED_THREADS = 8;
+        if (!annotation.thread_ids.empty()) {
+            text += annotation.thread_ids.size() == 1 ? "thread" : "threads";
+            for (size_t i = 0; i < std::min(annotation.thread_ids.size(), MAX_LISTED_THREADS); i++) {
+                text += " #" + std::to_string(annotation.thread_ids[i]);
+            }
+            if (annotation.thread_ids.size() > MAX_LISTED_THREADS) {
+                text += " and " + std::to_string(annotation.thread_ids.size() - MAX_LISTED_THREADS) + " more";
+            }
+            text += '\n';
+        }
+
+        for (lldb::break_id_t id : annotation.breakpoints) {
+            text += "breakpoint " + std::to_string(id) + '\n';
+        }
+        if (!annotation.breakpoints.empty()) {
+            text += std::to_string(annotation.breakpoint_hits) + " hits\n";
+        }
+
+        if (!text.empty()) {
+            text.pop_back();
+        }
+        markers.emplace(annotation.line, std::move(text));
+    }
+    return markers;
+}
+
+void draw_open_files(lldbg::Application& app, lldbg::UserInterface& ui)
+{
+    bool closed_tab = false;
+
+    app.open_files.for_each_open_file([&](const lldbg::FileReference& ref, bool is_focused) {
+        std::optional<lldbg::OpenFiles::Action> action;
+
+        // we programmatically set the focused tab if manual tab change requested
+        // for example when the user clicks an entry in the stack trace or file explorer
+        auto tab_flags = ImGuiTabItemFlags_None;
+        if (ui.request_manual_tab_change && is_focused) {
+            tab_flags = ImGuiTabItemFlags_SetSelected;
+            ui.text_editor.SetTextLines(*ref.contents);
+            ui.text_editor.SetBreakpoints(breakpoint_lines(app, ref.canonical_path.string()));
+        }
+
+        bool keep_tab_open = true;
+        if (ImGui::BeginTabItem(ref.short_name.c_str(), &keep_tab_open, tab_flags)) {
+            ImGui::BeginChild("FileContents");
+            if (!ui.request_manual_tab_change && !is_focused) {
+                // user selected tab directly with mouse
+                action = lldbg::OpenFiles::Action::ChangeFocusTo;
+                ui.text_editor.SetTextLines(*ref.contents);
+                ui.text_editor.SetBreakpoints(breakpoint_lines(app, ref.canonical_path.string()));
+            }
+            if (ui.scroll_to_line && is_focused) {
+                ui.text_editor.SetCursorPosition(TextEditor::Coordinates(*ui.scroll_to_line - 1, 0));
+                ui.scroll_to_line.reset();
+            }
+            ui.text_editor.Render("TextEditor");
+            ImGui::EndChild();
+            ImGui::EndTabItem();
+        }
+
+        if (!keep_tab_open) {
+            // user closed tab with mouse
+            closed_tab = true;
+            action = lldbg::OpenFiles::Action::Close;
+        }
+
+        return action;
+    });
+
+    ui.request_manual_tab_change = false;
+
+    if (closed_tab && app.open_files.size() > 0) {
+        const lldbg::FileReference ref = *app.open_files.focus();
+        ui.text_editor.SetTextLines(*ref.contents);
+        ui.text_editor.SetBreakpoints(breakpoint_lines(app, ref.canonical_path.string()));
+    }
+}
+
+void draw_file_browser(lldbg::Application& app, lldbg::UserInterface& ui, lldbg::FileBrowserNode* node_to_draw,
+                       size_t depth)
+{
+    if (node_to_draw->is_directory()) {
+        const char* tree_node_label = depth == 0 ? node_to_draw->full_path() : node_to_draw->filename();
+
+        if (MyTreeNode(tree_node_label)) {
+            node_to_draw->open_children();
+            for (auto& child_node : node_to_draw->children) {
+                draw_file_browser(app, ui, child_node.get(), depth + 1);
+            }
+            ImGui::TreePop();
+        }
+    }
+    else {
+        if (ImGui::Selectable(node_to_draw->filename())) {
+            manually_open_and_or_focus_file(app, ui, node_to_draw->full_path());
+        }
+    }
+}
+
+ImVec4 log_level_color(lldbg::LogLevel level)
+{
+    switch (level) {
+        case lldbg::LogLevel::Verbose:
+            return ImVec4(0.5f, 0.5f, 0.5f, 1.0f);
+        case lldbg::LogLevel::Debug:
+            return ImVec4(0.8f, 0.8f, 0.8f, 1.0f);
+        case lldbg::LogLevel::Info:
+            return ImVec4(0.4f, 0.8f, 1.0f, 1.0f);
+        case lldbg::LogLevel::Warning:
+            return ImVec4(1.0f, 0.8f, 0.2f, 1.0f);
+        case lldbg::LogLevel::Error:
+            return ImVec4(1.0f, 0.3f, 0.3f, 1.0f);
+    }
+    return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+}
+
+void draw_log(lldbg::UserInterface& ui)
+{
+    lldbg::LogView& view = ui.log_view;
+
+    static const char* level_names[] = {"Verbose", "Debug", "Info", "Warning", "Error"};
+    ImGui::PushItemWidth(120);
+    ImGui::Combo("##LogLevel", &ui.log_min_level, level_names, IM_ARRAYSIZE(level_names));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    ImGui::PushItemWidth(240);
+    ImGui::InputText("filter", ui.log_filter, sizeof(ui.log_filter));
+    ImGui::PopItemWidth();
+
+    const size_t old_size = view.size();
+    view.set_filter(*lldbg::g_logger, (lldbg::LogLevel)ui.log_min_level, ui.log_filter);
+    view.update(*lldbg::g_logger);
+
+    ImGui::SameLine();
+    ImGui::Text("%zu messages (%llu warnings, %llu errors)", view.size(),
+                (unsigned long long)view.total(lldbg::LogLevel::Warning),
+                (unsigned long long)view.total(lldbg::LogLevel::Error));
+
+    ImGui::BeginChild("LogEntries");
+
+    // only follow new messages if the user hasn't scrolled up to read older ones
+    const bool was_at_bottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)view.size());
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const lldbg::LogMessage& message = lldbg::g_logger->message(view[i]);
+            ImGui::TextColored(log_level_color(message.level), "[%9.3f] [%u] %s", message.timestamp_ns / 1e9,
+                               message.thread_id, message.message.c_str());
+        }
+    }
+
+    if (was_at_bottom && view.size() != old_size) {
+        ImGui::SetScrollHere(1.0f);
+    }
+
+    ImGui::EndChild();
+}
+
+ImU32 profile_section_color(const char* name)
+{
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    return ImColor::HSV((float)(hash % 360) / 360.0f, 0.5f, 0.6f);
+}
+
+void draw_registers(lldbg::TargetSession& session, lldbg::UserInterface& ui, const lldbg::StopSnapshot& snapshot)
+{
+    static const char* lane_format_names[(size_t)lldbg::LaneFormat::COUNT] = {};
+    if (lane_format_names[0] == nullptr) {
+        for (size_t i = 0; i < (size_t)lldbg::LaneFormat::COUNT; i++) {
+            lane_format_names[i] = lldbg::lane_format_name((lldbg::LaneFormat)i);
+        }
+    }
+
+    if ((size_t)ui.viewed_thread_index >= snapshot.threads.size()) {
+        return;
+    }
+
+    const uint32_t frame_index = (uint32_t)std::max(ui.viewed_frame_index, 0);
+    const lldbg::RegisterSnapshot& registers =
+        session.registers.get(session.target.GetProcess(), snapshot, (size_t)ui.viewed_thread_index, frame_index);
+
+    ImGui::PushItemWidth(120);
+    ImGui::Combo("vector lanes", &ui.register_lane_format, lane_format_names, IM_ARRAYSIZE(lane_format_names));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (registers.compared_stop_id == 0) {
+        ImGui::TextUnformatted("first read of this frame");
+    }
+    else if (registers.compared_stop_id == session.registers.previous_stop_id()) {
+        ImGui::Text("%zu changed since the previous stop", registers.num_changed);
+    }
+    else {
+        ImGui::Text("%zu changed since stop %u, when this frame was last read", registers.num_changed,
+                    registers.compared_stop_id);
+    }
+
+    ImGui::BeginChild("RegisterContents");
+    for (size_t i = 0; i < registers.sets.size(); i++) {
+        const lldbg::RegisterSetRange& set = registers.sets[i];
+        const std::string label = set.name + "##" + std::to_string(i);
+
+        if (MyTreeNode(label.c_str())) {
+            ImGui::Columns(2, nullptr, false);
+            for (size_t j = set.begin; j < set.end; j++) {
+                const lldbg::RegisterValue& value = registers.registers[j];
+
+                if (value.changed) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
+                }
+
+                ImGui::TextUnformatted(value.name.c_str());
+                ImGui::NextColumn();
+                if (value.is_vector && !value.bytes.empty()) {
+                    const std::string lanes =
+                        lldbg::format_lanes(value.bytes, (lldbg::LaneFormat)ui.register_lane_format);
+                    ImGui::TextUnformatted(lanes.c_str());
+                }
+                else {
+                    ImGui::TextUnformatted(value.value.c_str());
+                }
+                ImGui::NextColumn();
+
+                if (value.changed) {
+                    ImGui::PopStyleColor();
+                }
+            }
+            ImGui::Columns(1);
+            ImGui::TreePop();
+        }
+    }
+    ImGui::EndChild();
+}
+
+void draw_watchpoints(lldbg::Application& app, lldbg::UserInterface& ui, bool stopped)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (!session) {
+        return;
+    }
+
+    static const char* size_names[] = {"1 byte", "2 bytes", "4 bytes", "8 bytes"};
+    static const char* kind_names[] = {"write", "read", "read/write"};
+
+    ImGui::PushItemWidth(160);
+    ImGui::InputText("##WatchAddress", ui.watch_address, sizeof(ui.watch_address));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    ImGui::PushItemWidth(90);
+    ImGui::Combo("##WatchSize", &ui.watch_size_index, size_names, IM_ARRAYSIZE(size_names));
+    ImGui::SameLine();
+    ImGui::Combo("##WatchKind", &ui.watch_kind, kind_names, IM_ARRAYSIZE(kind_names));
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (ImGui::Button("Watch address") && stopped) {
+        char* end = nullptr;
+        const uint64_t address = strtoull(ui.watch_address, &end, 0);
+        if (end != ui.watch_address && *end == '\0') {
+            lldbg::add_watchpoint(app, address, (size_t)1 << ui.watch_size_index, (lldbg::WatchKind)ui.watch_kind);
+        }
+        else {
+            LOG(Warning) << "Not an address: " << ui.watch_address;
+        }
+    }
+
+    // the table is replaced whenever a watchpoint is modified, so changes are applied after drawing it
+    std::optional<std::pair<lldb::watch_id_t, bool>> toggled;
+    std::optional<lldb::watch_id_t> deleted;
+    bool condition_entered = false;
+
+    ImGui::Columns(6);
+    ImGui::Separator();
+    ImGui::Text("ID");
+    ImGui::NextColumn();
+    ImGui::Text("ENABLED");
+    ImGui::NextColumn();
+    ImGui::Text("WATCHING");
+    ImGui::NextColumn();
+    ImGui::Text("KIND");
+    ImGui::NextColumn();
+    ImGui::Text("HITS");
+    ImGui::NextColumn();
+    ImGui::Text("CONDITION");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (const lldbg::WatchpointDescription& watchpoint : session->watchpoints.watchpoints()) {
+        ImGui::PushID((int)watchpoint.id);
+
+        char id[16];
+        sprintf(id, "%d", (int)watchpoint.id);
+        const bool selected = ui.selected_watchpoint == watchpoint.id;
+        if (ImGui::Selectable(id, selected, ImGuiSelectableFlags_SpanAllColumns) && !selected) {
+            ui.selected_watchpoint = watchpoint.id;
+            snprintf(ui.watch_condition, sizeof(ui.watch_condition), "%s", watchpoint.condition.c_str());
+        }
+        ImGui::NextColumn();
+
+        bool enabled = watchpoint.enabled;
+        if (ImGui::Checkbox("##enabled", &enabled)) {
+            toggled = std::make_pair(watchpoint.id, enabled);
+        }
+        ImGui::NextColumn();
+
+        ImGui::Text("%s%s0x%llx (%zu bytes)", watchpoint.label.c_str(), watchpoint.label.empty() ? "" : " @ ",
+                    (unsigned long long)watchpoint.address, watchpoint.size);
+        if (watchpoint.enabled && watchpoint.hardware_index < 0 && ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("not installed in a hardware debug register");
+        }
+        ImGui::NextColumn();
+
+        ImGui::TextUnformatted(lldbg::watch_kind_name(watchpoint.kind));
+        ImGui::NextColumn();
+
+        if (watchpoint.ignore_count > 0) {
+            ImGui::Text("%u (ignoring %u)", watchpoint.hit_count, watchpoint.ignore_count);
+        }
+        else {
+            ImGui::Text("%u", watchpoint.hit_count);
+        }
+        ImGui::NextColumn();
+
+        ImGui::TextUnformatted(watchpoint.condition.c_str());
+        ImGui::NextColumn();
+
+        ImGui::PopID();
+    }
+
+    ImGui::Columns(1);
+
+    if (ui.selected_watchpoint) {
+        ImGui::Separator();
+        ImGui::PushItemWidth(320);
+        condition_entered = ImGui::InputText("condition", ui.watch_condition, sizeof(ui.watch_condition),
+                                             ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::PopItemWidth();
+        ImGui::SameLine();
+        if (ImGui::Button("Delete")) {
+            deleted = *ui.selected_watchpoint;
+        }
+    }
+
+    if (toggled) {
+        lldbg::set_watchpoint_enabled(app, toggled->first, toggled->second);
+    }
+
+    if (condition_entered) {
+        lldbg::set_watchpoint_condition(app, *ui.selected_watchpoint, ui.watch_condition);
+    }
+
+    if (deleted) {
+        lldbg::delete_watchpoint(app, *deleted);
+        ui.selected_watchpoint.reset();
+    }
+}
+
+void draw_breakpoints(lldbg::Application& app, lldbg::UserInterface& ui)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (!session) {
+        return;
+    }
+
+    const lldbg::BreakpointTable& table = session->breakpoint_table;
+    if (table.auto_resumes() > 0) {
+        ImGui::TextDisabled("%llu automatic resumes from false conditions or ignored hits, %.0f/s in the last run",
+                            (unsigned long long)table.auto_resumes(), table.auto_resumes_per_second());
+    }
+
+    // the table is replaced whenever a breakpoint is modified, so changes are applied after drawing it
+    std::optional<std::pair<lldb::break_id_t, bool>> toggled;
+    std::optional<lldb::break_id_t> deleted;
+    bool condition_entered = false;
+    bool ignore_count_entered = false;
+
+    ImGui::Columns(7);
+    ImGui::Separator();
+    ImGui::Text("ID");
+    ImGui::NextColumn();
+    ImGui::Text("ENABLED");
+    ImGui::NextColumn();
+    ImGui::Text("LOCATION");
+    ImGui::NextColumn();
+    ImGui::Text("HITS");
+    ImGui::NextColumn();
+    ImGui::Text("STOPS");
+    ImGui::NextColumn();
+    ImGui::Text("STOPPED");
+    ImGui::NextColumn();
+    ImGui::Text("CONDITION");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (const lldbg::BreakpointDescription& breakpoint : table.breakpoints()) {
+        ImGui::PushID((int)breakpoint.id);
+
+        char id[16];
+        sprintf(id, "%d", (int)breakpoint.id);
+        const bool selected = ui.selected_breakpoint == breakpoint.id;
+        if (ImGui::Selectable(id, selected, ImGuiSelectableFlags_SpanAllColumns) && !selected) {
+            ui.selected_breakpoint = breakpoint.id;
+            snprintf(ui.breakpoint_condition, sizeof(ui.breakpoint_condition), "%s", breakpoint.condition.c_str());
+            ui.breakpoint_ignore_count = (int)breakpoint.ignore_count;
+            if (!breakpoint.file_name.empty()) {
+                const std::string full_path = breakpoint.directory + breakpoint.file_name;
+                manually_open_and_or_focus_file(app, ui, full_path.c_str());
+            }
+        }
+        ImGui::NextColumn();
+
+        bool enabled = breakpoint.enabled;
+        if (ImGui::Checkbox("##enabled", &enabled)) {
+            toggled = std::make_pair(breakpoint.id, enabled);
+        }
+        ImGui::NextColumn();
+
+        if (breakpoint.file_name.empty()) {
+            ImGui::Text("%zu locations", breakpoint.num_locations);
+        }
+        else {
+            ImGui::Text("%s:%d", breakpoint.file_name.c_str(), breakpoint.line);
+        }
+        ImGui::NextColumn();
+
+        if (breakpoint.ignore_count > 0) {
+            ImGui::Text("%u (ignoring %u)", breakpoint.hit_count, breakpoint.ignore_count);
+        }
+        else {
+            ImGui::Text("%u", breakpoint.hit_count);
+        }
+        if (breakpoint.hits_per_second > 0 && ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("%.1f hits/s in the last run", breakpoint.hits_per_second);
+        }
+        ImGui::NextColumn();
+
+        ImGui::Text("%llu", (unsigned long long)breakpoint.stops);
+        ImGui::NextColumn();
+
+        if (breakpoint.stops > 0) {
+            ImGui::Text("%.1f s (%.0f ms avg)", (double)breakpoint.stopped_ns / 1e9,
+                        (double)breakpoint.stopped_ns / 1e6 / (double)breakpoint.stops);
+        }
+        ImGui::NextColumn();
+
+        ImGui::TextUnformatted(breakpoint.condition.c_str());
+        ImGui::NextColumn();
+
+        ImGui::PopID();
+    }
+
+    ImGui::Columns(1);
+
+    if (ui.selected_breakpoint) {
+        ImGui::Separator();
+        ImGui::PushItemWidth(320);
+        condition_entered = ImGui::InputText("condition##Breakpoint", ui.breakpoint_condition,
+                                             sizeof(ui.breakpoint_condition), ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::PopItemWidth();
+        ImGui::SameLine();
+        ImGui::PushItemWidth(100);
+        ignore_count_entered = ImGui::InputInt("ignore", &ui.breakpoint_ignore_count, 1, 100,
+                                               ImGuiInputTextFlags_EnterReturnsTrue);
+        ImGui::PopItemWidth();
+        ImGui::SameLine();
+        if (ImGui::Button("Delete##Breakpoint")) {
+            deleted = *ui.selected_breakpoint;
+        }
+    }
+
+    if (toggled) {
+        lldbg::set_breakpoint_enabled(app, toggled->first, toggled->second);
+    }
+
+    if (condition_entered) {
+        lldbg::set_breakpoint_condition(app, *ui.selected_breakpoint, ui.breakpoint_condition);
+    }
+
+    if (ignore_count_entered) {
+        ui.breakpoint_ignore_count = std::max(ui.breakpoint_ignore_count, 0);
+        lldbg::set_breakpoint_ignore_count(app, *ui.selected_breakpoint, (uint32_t)ui.breakpoint_ignore_count);
+    }
+
+    if (deleted) {
+        lldbg::delete_breakpoint(app, *deleted);
+        ui.selected_breakpoint.reset();
+    }
+}
+
+void show_memory(lldbg::UserInterface& ui, uint64_t address)
+{
+    const uint64_t half_view = lldbg::UserInterface::MEMORY_VIEW_BYTES / 2;
+    ui.memory_base = lldbg::MemoryCache::page_address(address > half_view ? address - half_view : 0);
+    ui.memory_scroll_to = address;
+    snprintf(ui.memory_address, sizeof(ui.memory_address), "0x%llx", (unsigned long long)address);
+}
+
+void draw_memory(lldbg::TargetSession& session, lldbg::UserInterface& ui, bool stopped)
+{
+    lldb::SBProcess process = session.target.GetProcess();
+
+    constexpr uint64_t BYTES_PER_ROW = 16;
+
+    ImGui::PushItemWidth(200);
+    const bool entered = ImGui::InputText("##MemoryAddress", ui.memory_address, sizeof(ui.memory_address),
+                                          ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (ImGui::Button("Go") || entered) {
+        char* end = nullptr;
+        const uint64_t address = strtoull(ui.memory_address, &end, 0);
+        if (end != ui.memory_address && *end == '\0') {
+            show_memory(ui, address);
+        }
+        else {
+            LOG(Warning) << "Not an address: " << ui.memory_address;
+        }
+    }
+    ImGui::SameLine();
+    ImGui::Text("%zu pages cached (%llu hits, %llu misses)", session.memory.size(),
+                (unsigned long long)session.memory.hits(), (unsigned long long)session.memory.misses());
+
+    ImGui::BeginChild("MemoryRows");
+
+    if (stopped) {
+        const float row_height = ImGui::GetTextLineHeightWithSpacing();
+        if (ui.memory_scroll_to) {
+            ImGui::SetScrollY((float)((*ui.memory_scroll_to - ui.memory_base) / BYTES_PER_ROW) * row_height);
+            ui.memory_scroll_to.reset();
+        }
+
+        const uint64_t num_rows =
+            std::min(lldbg::UserInterface::MEMORY_VIEW_BYTES, UINT64_MAX - ui.memory_base) / BYTES_PER_ROW;
+
+        ImGuiListClipper clipper;
+        clipper.Begin((int)num_rows, row_height);
+        while (clipper.Step()) {
+            // read ahead in the direction of scrolling
+            const lldbg::MemoryCache::Direction direction = clipper.DisplayStart < ui.memory_first_row
+                                                                ? lldbg::MemoryCache::Direction::Backward
+                                                                : lldbg::MemoryCache::Direction::Forward;
+            ui.memory_first_row = clipper.DisplayStart;
+
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const uint64_t row_address = ui.memory_base + (uint64_t)row * BYTES_PER_ROW;
+                const lldbg::MemoryPage& page = session.memory.page(process, row_address, direction);
+                const uint8_t* bytes = page.readable ? &page.bytes[row_address - page.address] : nullptr;
+
+                char line[128];
+                int length = snprintf(line, sizeof(line), "%016llx  ", (unsigned long long)row_address);
+                for (uint64_t i = 0; i < BYTES_PER_ROW; i++) {
+                    length += bytes ? snprintf(line + length, sizeof(line) - length, "%02x ", bytes[i])
+                                    : snprintf(line + length, sizeof(line) - length, "?? ");
+                    if (i == BYTES_PER_ROW / 2 - 1) {
+                        line[length++] = ' ';
+                    }
+                }
+                line[length++] = ' ';
+                for (uint64_t i = 0; i < BYTES_PER_ROW; i++) {
+                    line[length++] = bytes && bytes[i] >= 0x20 && bytes[i] < 0x7f ? (char)bytes[i] : '.';
+                }
+                line[length] = '\0';
+
+                ImGui::TextUnformatted(line);
+            }
+        }
+    }
+
+    ImGui::EndChild();
+}
+
+void draw_disassembly(lldbg::TargetSession& session, lldbg::UserInterface& ui, const lldbg::StopSnapshot* snapshot)
+{
+    ImGui::Checkbox("mixed source", &ui.disassembly_mixed);
+    ImGui::SameLine();
+    ImGui::PushItemWidth(200);
+    const bool entered = ImGui::InputText("##DisassemblyAddress", ui.disassembly_address,
+                                          sizeof(ui.disassembly_address), ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGui::PopItemWidth();
+    ImGui::SameLine();
+    if (ImGui::Button("Go##Disassembly") || entered) {
+        char* end = nullptr;
+        const uint64_t address = strtoull(ui.disassembly_address, &end, 0);
+        if (end != ui.disassembly_address && *end == '\0') {
+            ui.disassembly_override = address;
+            ui.disassembly_scroll_pending = true;
+        }
+        else {
+            LOG(Warning) << "Not an address: " << ui.disassembly_address;
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Follow pc")) {
+        ui.disassembly_override.reset();
+        ui.disassembly_scroll_pending = true;
+    }
+
+    std::optional<uint64_t> pc;
+    if (snapshot && ui.viewed_thread_index >= 0 && (size_t)ui.viewed_thread_index < snapshot->threads.size()) {
+        const std::vector<lldbg::FrameSnapshot>& frames = snapshot->threads[ui.viewed_thread_index].frames;
+        const size_t frame_index = (size_t)std::max(ui.viewed_frame_index, 0);
+        if (frame_index < frames.size()) {
+            pc = frames[frame_index].pc;
+        }
+    }
+
+    const std::optional<uint64_t> address = ui.disassembly_override ? ui.disassembly_override : pc;
+    if (!snapshot || !address) {
+        return;
+    }
+
+    // follow the pc to wherever the process stopped
+    if (!ui.disassembly_override && (snapshot->stop_id != ui.disassembly_stop_id || *pc != ui.disassembly_pc)) {
+        ui.disassembly_stop_id = snapshot->stop_id;
+        ui.disassembly_pc = *pc;
+        ui.disassembly_scroll_pending = true;
+    }
+
+    const lldbg::DisassembledFunction& function = session.disassembly.get(session.target, *address);
+    ImGui::SameLine();
+    ImGui::Text("%s [0x%llx, 0x%llx)", function.name.c_str(), (unsigned long long)function.start,
+                (unsigned long long)function.end);
+
+    ImGui::BeginChild("DisassemblyRows");
+
+    const size_t focus = function.instruction_index(*address);
+    const size_t num_rows = ui.disassembly_mixed ? function.mixed.size() : function.instructions.size();
+    const float row_height = ImGui::GetTextLineHeightWithSpacing();
+
+    if (ui.disassembly_scroll_pending && !function.instructions.empty()) {
+        size_t focus_row = focus;
+        if (ui.disassembly_mixed) {
+            for (size_t i = 0; i < function.mixed.size(); i++) {
+                if (!function.mixed[i].is_source && function.mixed[i].instruction == focus) {
+                    focus_row = i;
+                    break;
+                }
+            }
+        }
+        ImGui::SetScrollY(std::max(0.0f, ((float)focus_row - 5.0f) * row_height));
+        ui.disassembly_scroll_pending = false;
+    }
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)num_rows, row_height);
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            size_t index = (size_t)row;
+            if (ui.disassembly_mixed) {
+                const lldbg::MixedRow& mixed_row = function.mixed[row];
+                if (mixed_row.is_source) {
+                    ImGui::TextColored(ImVec4(0.5f, 0.7f, 0.5f, 1.0f), "%s", mixed_row.source.c_str());
+                    continue;
+                }
+                index = mixed_row.instruction;
+            }
+
+            const lldbg::DisassembledInstruction& instruction = function.instructions[index];
+            if (pc && instruction.address == *pc) {
+                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "=> %s", instruction.text.c_str());
+            }
+            else {
+                ImGui::Text("   %s", instruction.text.c_str());
+            }
+        }
+    }
+
+    ImGui::EndChild();
+}
+
+void draw_profiler(lldbg::UserInterface& ui)
+{
+    ImGui::SetNextWindowSize(ImVec2(720, 520), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", &ui.show_profiler)) {
+        ImGui::End();
+        return;
+    }
+    Defer(ImGui::End());
+
+    lldbg::Profiler& profiler = lldbg::g_profiler;
+
+    bool paused = profiler.paused();
+    if (ImGui::Checkbox("Pause", &paused)) {
+        profiler.set_paused(paused);
+    }
+
+    const size_t num_frames = profiler.completed_frames();
+    if (num_frames == 0) {
+        return;
+    }
+
+    // frame time history, oldest on the left
+    std::vector<float> frame_times_ms(num_frames);
+    for (size_t i = 0; i < num_frames; i++) {
+        frame_times_ms[num_frames - 1 - i] = (float)profiler.completed_frame(i).duration_ns / 1e6f;
+    }
+    ImGui::SameLine();
+    ImGui::PlotLines("frame time (ms)", frame_times_ms.data(), (int)num_frames, 0, NULL, 0.0f, FLT_MAX,
+                     ImVec2(0, 60));
+
+    // timeline of the last frame, one row per nesting depth
+    const lldbg::ProfileFrame& frame = profiler.completed_frame(0);
+    ImGui::Text("last frame: %.3f ms", (double)frame.duration_ns / 1e6);
+
+    const float row_height = ImGui::GetTextLineHeightWithSpacing();
+    const float width = ImGui::GetContentRegionAvail().x;
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const ImVec2 mouse = ImGui::GetIO().MousePos;
+    const double ns_to_px = frame.duration_ns > 0 ? (double)width / (double)frame.duration_ns : 0.0;
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    uint32_t max_depth = 0;
+    for (const lldbg::ProfileSample& sample : frame.samples) {
+        max_depth = std::max(max_depth, sample.depth);
+
+        const float x0 = origin.x + (float)((double)sample.start_ns * ns_to_px);
+        const float x1 =
+            std::max(x0 + 1.0f, origin.x + (float)((double)(sample.start_ns + sample.duration_ns) * ns_to_px));
+        const float y0 = origin.y + (float)sample.depth * row_height;
+        const float y1 = y0 + row_height - 1.0f;
+
+        draw_list->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), profile_section_color(sample.name));
+        if (x1 - x0 > ImGui::CalcTextSize(sample.name).x + 4.0f) {
+            draw_list->AddText(ImVec2(x0 + 2.0f, y0), ImGui::GetColorU32(ImGuiCol_Text), sample.name);
+        }
+
+        if (mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1) {
+            ImGui::SetTooltip("%s: %.3f ms", sample.name, (double)sample.duration_ns / 1e6);
+        }
+    }
+    ImGui::Dummy(ImVec2(width, (float)(max_depth + 1) * row_height));
+
+    // rolling statistics over all recorded frames
+    ImGui::Separator();
+    ImGui::Columns(5);
+    ImGui::Text("SECTION");
+    ImGui::NextColumn();
+    ImGui::Text("P50 (us)");
+    ImGui::NextColumn();
+    ImGui::Text("P99 (us)");
+    ImGui::NextColumn();
+    ImGui::Text("MAX (us)");
+    ImGui::NextColumn();
+    ImGui::Text("CALLS/FRAME");
+    ImGui::NextColumn();
+    ImGui::Separator();
+
+    for (const lldbg::ProfileSectionStats& stats : profiler.section_stats()) {
+        ImGui::Indent((float)stats.depth * 8.0f + 1.0f);
+        ImGui::TextUnformatted(stats.name);
+        ImGui::Unindent((float)stats.depth * 8.0f + 1.0f);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", stats.p50_us);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", stats.p99_us);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", stats.max_us);
+        ImGui::NextColumn();
+        ImGui::Text("%.2f", stats.calls_per_frame);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+void draw_sb_trace(lldbg::UserInterface& ui)
+{
+    ImGui::SetNextWindowSize(ImVec2(720, 300), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("SB API Calls", &ui.show_sb_trace)) {
+        ImGui::End();
+        return;
+    }
+    Defer(ImGui::End());
+
+    bool enabled = lldbg::g_sb_trace.enabled();
+    if (ImGui::Checkbox("Trace SB API calls", &enabled)) {
+        lldbg::g_sb_trace.set_enabled(enabled);
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Save histograms")) {
+        const fs::path path = fs::current_path() / "lldbg_sb_histograms.txt";
+        if (lldbg::g_sb_trace.write_histograms(path)) {
+            LOG(Info) << "Wrote SB API latency histograms to " << path;
+        }
+        else {
+            LOG(Error) << "Failed to write SB API latency histograms to " << path;
+        }
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Save Chrome trace")) {
+        const fs::path path = fs::current_path() / "lldbg_sb_trace.json";
+        if (lldbg::g_sb_trace.write_chrome_trace(path)) {
+            LOG(Info) << "Wrote SB API call trace to " << path;
+        }
+        else {
+            LOG(Error) << "Failed to write SB API call trace to " << path;
+        }
+    }
+
+    ImGui::Separator();
+    ImGui::Columns(7);
+    for (const char* header :
+         {"CATEGORY", "CALLS/FRAME", "US/FRAME", "TOTAL CALLS", "P50 (us)", "P99 (us)", "MAX (us)"}) {
+        ImGui::Text("%s", header);
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+
+    const lldbg::SBCallsByCategory last_frame = lldbg::g_sb_trace.last_frame();
+    for (size_t i = 0; i < last_frame.size(); i++) {
+        const lldbg::SBCallCategory category = (lldbg::SBCallCategory)i;
+        const lldbg::LatencyHistogram histogram = lldbg::g_sb_trace.histogram(category);
+
+        ImGui::TextUnformatted(lldbg::sb_call_category_name(category));
+        ImGui::NextColumn();
+        ImGui::Text("%lu", (unsigned long)last_frame[i].calls);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", (double)last_frame[i].total_ns / 1000.0);
+        ImGui::NextColumn();
+        ImGui::Text("%lu", (unsigned long)histogram.count());
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", (double)histogram.percentile_ns(0.5) / 1000.0);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", (double)histogram.percentile_ns(0.99) / 1000.0);
+        ImGui::NextColumn();
+        ImGui::Text("%.1f", (double)histogram.max_ns() / 1000.0);
+        ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+}
+
+void start_attach(lldbg::Application& app, lldbg::UserInterface& ui)
+{
+    if (ui.attach_target[0] == '\0') {
+        return;
+    }
+
+    char* end = nullptr;
+    const unsigned long long pid = strtoull(ui.attach_target, &end, 10);
+
+    std::optional<lldbg::TargetStartError> error;
+    if (*end == '\0' && !ui.attach_wait_for_launch) {
+        error = lldbg::attach_to_process(app, (lldb::pid_t)pid);
+    }
+    else {
+        error = lldbg::attach_to_process(app, ui.attach_target, ui.attach_wait_for_launch);
+    }
+
+    if (error) {
+        app.attach_error = error->msg;
+    }
+}
+
+void draw_process_picker(lldbg::Application& app, lldbg::UserInterface& ui)
+{
+    ui.process_list.refresh_if_stale();
+
+    ImGui::InputText("Filter##Processes", ui.process_filter, sizeof(ui.process_filter));
+    const std::vector<lldbg::ProcessInfo>& processes = ui.process_list.processes();
+    const std::vector<size_t>& shown = ui.process_list.filter(ui.process_filter);
+    ImGui::SameLine();
+    ImGui::TextDisabled("%zu of %zu", shown.size(), processes.size());
+
+    ImGui::BeginChild("ProcessPicker", ImVec2(0, 300), true);
+    Defer(ImGui::EndChild());
+
+    ImGui::Columns(4);
+    for (const char* header : {"PID", "UID", "NAME", "COMMAND LINE"}) {
+        ImGui::Text("%s", header);
+        ImGui::NextColumn();
+    }
+    ImGui::Separator();
+
+    const int32_t selected_pid = atoi(ui.attach_target);
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)shown.size());
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            const lldbg::ProcessInfo& process = processes[shown[row]];
+
+            char pid[16];
+            snprintf(pid, sizeof(pid), "%d", process.pid);
+            if (ImGui::Selectable(pid, process.pid == selected_pid,
+                                  ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+                snprintf(ui.attach_target, sizeof(ui.attach_target), "%d", process.pid);
+                ui.attach_wait_for_launch = false;
+                if (ImGui::IsMouseDoubleClicked(0)) {
+                    start_attach(app, ui);
+                }
+            }
+            ImGui::NextColumn();
+            ImGui::Text("%u", process.uid);
+            ImGui::NextColumn();
+            ImGui::TextUnformatted(process.name.c_str());
+            ImGui::NextColumn();
+            if (process.command_line.empty()) {
+                ImGui::TextDisabled("[%s]", process.name.c_str());
+            }
+            else {
+                ImGui::TextUnformatted(process.command_line.c_str());
+            }
+            ImGui::NextColumn();
+        }
+    }
+    ImGui::Columns(1);
+}
+
+void draw_attach(lldbg::Application& app, lldbg::UserInterface& ui)
+{
+    ImGui::SetNextWindowSize(ImVec2(720, 0), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Attach to Process", &ui.show_attach)) {
+        ImGui::End();
+        return;
+    }
+    Defer(ImGui::End());
+
+    if (app.pending_attach) {
+        const double elapsed_s =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - app.pending_attach->start).count();
+        ImGui::Text("Attaching to %s... %.1f s", app.pending_attach->description.c_str(), elapsed_s);
+        if (app.pending_attach->cancelled) {
+            ImGui::TextUnformatted("Cancelling...");
+        }
+        else if (ImGui::Button("Cancel")) {
+            lldbg::cancel_attach(app);
+        }
+        return;
+    }
+
+    ImGui::InputText("PID or name", ui.attach_target, sizeof(ui.attach_target));
+    ImGui::SameLine();
+    ImGui::Checkbox("Wait for launch", &ui.attach_wait_for_launch);
+    ImGui::SameLine();
+    if (ImGui::Button("Attach")) {
+        start_attach(app, ui);
+    }
+
+    if (!app.attach_error.empty()) {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
+        ImGui::TextWrapped("%s", app.attach_error.c_str());
+        ImGui::PopStyleColor();
+    }
+
+    ImGui::Separator();
+    draw_process_picker(app, ui);
+}
+
+void draw_open_core(lldbg::Application& app, lldbg::UserInterface& ui)
+{
+    ImGui::SetNextWindowSize(ImVec2(520, 0), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Open Core File", &ui.show_open_core)) {
+        ImGui::End();
+        return;
+    }
+    Defer(ImGui::End());
+
+    ImGui::InputText("Executable", ui.core_executable, sizeof(ui.core_executable));
+    ImGui::InputText("Core file", ui.core_file, sizeof(ui.core_file));
+
+    if (ImGui::Button("Open") && ui.core_executable[0] != '\0' && ui.core_file[0] != '\0') {
+        const std::optional<lldbg::TargetStartError> error =
+            lldbg::open_core_file(app, ui.core_executable, ui.core_file);
+        if (error) {
+            ui.core_error = error->msg;
+        }
+        else {
+            ui.core_error.clear();
+            ui.show_open_core = false;
+        }
+    }
+
+    if (!ui.core_error.empty()) {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.3f, 1.0f));
+        ImGui::TextWrapped("%s", ui.core_error.c_str());
+        ImGui::PopStyleColor();
+    }
+}
+
+void draw_thread_groups(lldbg::TargetSession& session, lldbg::UserInterface& ui, lldbg::StopSnapshot& snapshot)
+{
+    lldb::SBProcess process = session.target.GetProcess();
+    const lldbg::ThreadGrouping* grouping = session.thread_groups.get(process, snapshot);
+    if (!grouping) {
+        ImGui::TextDisabled("Grouping %zu threads by stack...", snapshot.threads.size());
+        return;
+    }
+
+    ImGui::TextDisabled("%zu threads, %zu distinct stacks", snapshot.threads.size(), grouping->groups.size());
+
+    for (const lldbg::ThreadGroup& group : grouping->groups) {
+        char label[512];
+        snprintf(label, sizeof(label), "%zu x %s##%016llx", group.threads.size(),
+                 group.pcs.empty() ? "(no frames)"
+                                   : (group.function_name.empty() ? "unknown" : group.function_name.c_str()),
+                 (unsigned long long)group.stack_hash);
+        if (!MyTreeNode(label)) {
+            continue;
+        }
+        Defer(ImGui::TreePop());
+
+        // only the first thread of an open group is symbolicated, its stack stands for all of them
+        const size_t representative = group.threads.front();
+        snapshot.load_frames(process, representative);
+        for (const lldbg::FrameSnapshot& frame : snapshot.threads[representative].frames) {
+            ImGui::TextDisabled("0x%016llx %s %s:%d", (unsigned long long)frame.pc,
+                                frame.function_name.empty() ? "unknown" : frame.function_name.c_str(),
+                                frame.file_name.empty() ? "?" : frame.file_name.c_str(), frame.line);
+        }
+
+        ImGuiListClipper clipper;
+        clipper.Begin((int)group.threads.size());
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const size_t thread_index = group.threads[row];
+                const lldbg::ThreadSnapshot& thread = snapshot.threads[thread_index];
+                char thread_label[256];
+                snprintf(thread_label, sizeof(thread_label), "Thread %zu (tid %llu) %s", thread_index,
+                         (unsigned long long)thread.thread_id, thread.name.c_str());
+                if (ImGui::Selectable(thread_label, (int)thread_index == ui.viewed_thread_index)) {
+                    ui.viewed_thread_index = (int)thread_index;
+                }
+            }
+        }
+    }
+}
+
+// shown until LLDB is initialized
+void draw_startup(lldbg::UserInterface& ui)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    ImGui::SetNextWindowPos(ImVec2(0.f, 0.f), ImGuiSetCond_Always);
+    ImGui::SetNextWindowSize(io.DisplaySize, ImGuiSetCond_Always);
+
+    ImGui::Begin("lldbg", 0,
+                 ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+                     ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoTitleBar);
+    Defer(ImGui::End());
+
+    ImGui::PushFont(ui.font);
+    ImGui::SetCursorPos(ImVec2(io.DisplaySize.x / 2 - 100, io.DisplaySize.y / 2));
+    ImGui::Text("Starting debugger... %.1f s", (double)ImGui::GetTime());
+    ImGui::PopFont();
+}
+
+}  // namespace
+
+namespace lldbg {
+
+void draw(Application& app, UserInterface& ui)
+{
+    PROFILE_SCOPE("draw");
+
+    lldb::SBProcess process = get_process(app);
+    TargetSession* session = selected_session(app);
+    StopSnapshot* snapshot = session && session->stop_snapshot ? &*session->stop_snapshot : nullptr;
+    const bool stopped = snapshot != nullptr;
+
+    if (stopped && ui.viewed_thread_index >= (int)snapshot->threads.size()) {
+        ui.viewed_thread_index = -1;
+        ui.viewed_frame_index = -1;
+    }
+
+    // a no-op unless the stacks are loaded on demand, as for core files
+    if (stopped && ui.viewed_thread_index >= 0) {
+        snapshot->load_frames(process, (size_t)ui.viewed_thread_index);
+    }
+
+    // ImGuiIO& io = ImGui::GetIO();
+    // io.FontGlobalScale = 1.1;
+
+    static int window_width = glutGet(GLUT_WINDOW_WIDTH);
+    static int window_height = glutGet(GLUT_WINDOW_HEIGHT);
+
+    bool window_resized = false;
+    const int old_width = window_width;
+    const int old_height = window_height;
+    const int new_width = glutGet(GLUT_WINDOW_WIDTH);
+    const int new_height = glutGet(GLUT_WINDOW_HEIGHT);
+    if (new_width != old_width || new_height != old_height) {
+        window_width = new_width;
+        window_height = new_height;
+        window_resized = true;
+    }
+
+    ImGui::SetNextWindowPos(ImVec2(0.f, 0.f), ImGuiSetCond_Always);
+    ImGui::SetNextWindowSize(ImVec2(window_width, window_height), ImGuiSetCond_Always);
+
+    ImGui::Begin("lldbg", 0,
+                 ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_MenuBar |
+                     ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse |
+                     ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoTitleBar);
+    ImGui::PushFont(ui.font);
+
+    if (ImGui::BeginMenuBar()) {
+        Defer(ImGui::EndMenuBar());
+
+        if (ImGui::BeginMenu("File")) {
+            Defer(ImGui::EndMenu());
+            if (ImGui::MenuItem("Open..", "Ctrl+O")) { /* Do stuff */
+            }
+            ImGui::MenuItem("Open Core File..", NULL, &ui.show_open_core);
+            ImGui::MenuItem("Attach..", NULL, &ui.show_attach);
+            if (ImGui::MenuItem("Save", "Ctrl+S")) { /* Do stuff */
+            }
+            if (ImGui::MenuItem("Close", "Ctrl+W")) { /* Do stuff */
+            }
+        }
+
+        if (ImGui::BeginMenu("View")) {
+            Defer(ImGui::EndMenu());
+            if (ImGui::MenuItem("Layout", NULL)) { /* Do stuff */
+            }
+            ImGui::MenuItem("Profiler", NULL, &ui.show_profiler);
+            ImGui::MenuItem("SB API Calls", NULL, &ui.show_sb_trace);
+            if (ImGui::MenuItem("Zoom In", "+")) { /* Do stuff */
+            }
+            if (ImGui::MenuItem("Zoom Out", "-")) { /* Do stuff */
+            }
+        }
+
+        if (ImGui::BeginMenu("Help")) {
+            Defer(ImGui::EndMenu());
+            if (ImGui::MenuItem("About", "F12")) { /* Do stuff */
+            }
+        }
+    }
+
+    static float file_browser_width =
+        (float)window_width * ui.DEFAULT_FILEBROWSER_WIDTH_PERCENT;
+    static float file_viewer_width = (float)window_width * ui.DEFAULT_FILEVIEWER_WIDTH_PERCENT;
+    Splitter("##S1", true, 3.0f, &file_browser_width, &file_viewer_width, 100, 100, window_height);
+
+    if (window_resized) {
+        file_browser_width = file_browser_width * (float)new_width / (float)old_width;
+        file_viewer_width = file_viewer_width * (float)new_width / (float)old_width;
+    }
+
+    {  // start file browser
+        PROFILE_SCOPE("file browser");
+        ImGui::BeginChild("FileBrowserPane", ImVec2(file_browser_width, 0));
+
+        if (ImGui::Button("Resume")) {
+            get_process(app).Continue();
+        }
+        ImGui::SameLine();
+
+        if (ImGui::Button("Stop")) {
+            get_process(app).Stop();
+        }
+
+        if (session && session->symbols && !session->symbols->finished()) {
+            const SymbolPreloader& symbols = *session->symbols;
+            char progress[64];
+            snprintf(progress, sizeof(progress), "symbols %zu/%zu", symbols.modules_done(), symbols.modules_total());
+            ImGui::ProgressBar((float)symbols.modules_done() / (float)symbols.modules_total(), ImVec2(-1, 0),
+                               progress);
+        }
+        ImGui::Separator();
+
+        draw_file_browser(app, ui, app.file_browser.get(), 0);
+        ImGui::EndChild();
+    }  // end file browser
+
+    ImGui::SameLine();
+
+    ImGui::BeginGroup();
+
+    static float file_viewer_height = window_height / 2;
+    static float console_height = window_height / 2;
+
+    const float old_console_height = console_height;
+
+    Splitter("##S2", false, 3.0f, &file_viewer_height, &console_height, 100, 100, file_viewer_width);
+
+    if (window_resized) {
+        file_viewer_height = file_viewer_height * (float)new_height / (float)old_height;
+        console_height = console_height * (float)new_height / (float)old_height;
+    }
+
+    {  // start file viewer
+        PROFILE_SCOPE("file viewer");
+        ImGui::BeginChild("FileViewer", ImVec2(file_viewer_width, file_viewer_height));
+        if (ImGui::BeginTabBar("##FileViewerTabs",
+                               ImGuiTabBarFlags_AutoSelectNewTabs | ImGuiTabBarFlags_NoTooltip)) {
+            Defer(ImGui::EndTabBar());
+
+            if (app.open_files.size() == 0) {
+                if (ImGui::BeginTabItem("about")) {
+                    Defer(ImGui::EndTabItem());
+                    ImGui::TextUnformatted("This is a GUI for lldb.");
+                }
+            }
+            else {
+                draw_open_files(app, ui);
+            }
+        }
+        ImGui::EndChild();
+    }  // end file viewer
+
+    ImGui::Spacing();
+
+    {  // start console/log
+        PROFILE_SCOPE("console/log");
+        ImGui::BeginChild("LogConsole",
+                          ImVec2(file_viewer_width, console_height - 2 * ImGui::GetFrameHeightWithSpacing()));
+        if (ImGui::BeginTabBar("##ConsoleLogTabs", ImGuiTabBarFlags_None)) {
+            if (ImGui::BeginTabItem("Console")) {
+                ImGui::BeginChild("ConsoleEntries");
+
+                // the history can be millions of lines long, so only submit the visible ones
+                const lldbg::LineBuffer& history = app.command_line.get_history();
+                ImGuiListClipper clipper;
+                clipper.Begin((int)history.line_count());
+                while (clipper.Step()) {
+                    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                        switch ((lldbg::ConsoleLineKind)history.line_tag(i)) {
+                            case lldbg::ConsoleLineKind::Input:
+                                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(255, 0, 0, 255));
+                                ImGui::TextUnformatted(history.line_begin(i), history.line_end(i));
+                                ImGui::PopStyleColor();
+                                break;
+                            case lldbg::ConsoleLineKind::Error:
+                                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.5f, 0.0f, 1.0f));
+                                ImGui::TextUnformatted(history.line_begin(i), history.line_end(i));
+                                ImGui::PopStyleColor();
+                                break;
+                            case lldbg::ConsoleLineKind::Output:
+                                ImGui::TextUnformatted(history.line_begin(i), history.line_end(i));
+                                break;
+                        }
+                    }
+                }
+
+                // always scroll to the bottom of the command history after running a command
+                const bool should_auto_scroll_command_window =
+                    ui.ran_command_last_frame || old_console_height != console_height;
+
+                // up/down arrows recall commands from the persistent history
+                auto command_input_callback = [](ImGuiTextEditCallbackData* data) -> int {
+                    lldbg::CommandHistory* history = static_cast<lldbg::CommandHistory*>(data->UserData);
+                    const std::optional<std::string> recalled =
+                        data->EventKey == ImGuiKey_UpArrow ? history->previous() : history->next();
+                    if (recalled) {
+                        data->DeleteChars(0, data->BufTextLen);
+                        data->InsertChars(0, recalled->c_str());
+                    }
+                    return 0;
+                };
+
+                const ImGuiInputTextFlags command_input_flags =
+                    ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CallbackHistory;
+
+                lldbg::CommandHistory& persistent_history = app.command_line.get_persistent_history();
+                HistorySearch& search = ui.history_search;
+
+                static char input_buf[2048];
+                if (ImGui::InputText("lldb console", input_buf, 2048, command_input_flags,
+                                     command_input_callback, &persistent_history)) {
+                    run_lldb_command(app, input_buf);
+                    strcpy(input_buf, "");
+                    ui.ran_command_last_frame = true;
+                }
+
+                // Keep auto focus on the input box
+                if (!search.active &&
+                    (ImGui::IsItemHovered() || (ImGui::IsRootWindowOrAnyChildFocused() &&
+                                                !ImGui::IsAnyItemActive() && !ImGui::IsMouseClicked(0))))
+                    ImGui::SetKeyboardFocusHere(-1);  // Auto focus previous widget
+
+                // Ctrl-R starts a reverse search, pressing it again jumps to the next older match
+                if (ImGui::GetIO().KeyCtrl && ImGui::IsKeyPressed('R', false)) {
+                    if (!search.active) {
+                        search = HistorySearch();
+                        search.active = true;
+                        search.request_focus = true;
+                    }
+                    else if (search.match) {
+                        const std::optional<size_t> older = persistent_history.search(search.query, search.match);
+                        if (older) {
+                            search.match = older;
+                        }
+                    }
+                }
+
+                if (search.active) {
+                    if (search.request_focus) {
+                        ImGui::SetKeyboardFocusHere();
+                        search.request_focus = false;
+                    }
+
+                    const bool accepted = ImGui::InputText("reverse-i-search", search.query, sizeof(search.query),
+                                                           ImGuiInputTextFlags_EnterReturnsTrue);
+
+                    if (search.last_query != search.query) {
+                        search.last_query = search.query;
+                        search.match = persistent_history.search(search.query);
+                    }
+
+                    if (search.match) {
+                        ImGui::TextUnformatted(persistent_history[*search.match].command.c_str());
+                    }
+                    else if (search.query[0] != '\0') {
+                        ImGui::TextDisabled("no match");
+                    }
+
+                    if (accepted) {
+                        if (search.match) {
+                            const std::string& command = persistent_history[*search.match].command;
+                            snprintf(input_buf, sizeof(input_buf), "%s", command.c_str());
+                        }
+                        search.active = false;
+                    }
+                    else if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Escape))) {
+                        search.active = false;
+                    }
+                }
+
+                if (should_auto_scroll_command_window) {
+                    ImGui::SetScrollHere(1.0f);
+                    ui.ran_command_last_frame = false;
+                }
+
+                ImGui::EndChild();
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Log")) {
+                draw_log(ui);
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Memory")) {
+                if (session) {
+                    draw_memory(*session, ui, stopped);
+                }
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Disassembly")) {
+                if (session) {
+                    draw_disassembly(*session, ui, snapshot);
+                }
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+        ImGui::EndChild();
+    }  // end console/log
+
+    ImGui::EndGroup();
+
+    ImGui::SameLine();
+
+    ImGui::BeginGroup();
+
+    const float threads_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
+    const float stack_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
+    const float locals_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
+    const float breakpoint_height = (window_height - 2 * ImGui::GetFrameHeightWithSpacing()) / 4;
+
+    {  // start threads
+        PROFILE_SCOPE("threads");
+        ImGui::BeginChild("#ThreadsChild",
+                          ImVec2(window_width - file_browser_width - file_viewer_width, threads_height));
+        if (ImGui::BeginTabBar("#ThreadsTabs", ImGuiTabBarFlags_None)) {
+            if (ImGui::BeginTabItem("Threads")) {
+                if (stopped) {
+                    // core files can have thousands of threads
+                    ImGuiListClipper clipper;
+                    clipper.Begin((int)snapshot->threads.size());
+                    while (clipper.Step()) {
+                        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                            char label[128];
+                            sprintf(label, "Thread %d", i);
+                            // threads back at the same stack without a stop reason didn't run, and are dimmed
+                            const bool changed = snapshot->threads[i].changed;
+                            if (!changed) {
+                                ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+                            }
+                            if (ImGui::Selectable(label, i == ui.viewed_thread_index)) {
+                                ui.viewed_thread_index = i;
+                            }
+                            if (!changed) {
+                                ImGui::PopStyleColor();
+                            }
+                        }
+                    }
+
+                    if (!snapshot->threads.empty() && ui.viewed_thread_index < 0) {
+                        ui.viewed_thread_index = (int)snapshot->selected_thread;
+                    }
+                }
+                ImGui::EndTabItem();
+            }
+            // only computed while this tab is open
+            if (ImGui::BeginTabItem("Grouped")) {
+                if (stopped) {
+                    draw_thread_groups(*session, ui, *snapshot);
+                }
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem("Targets")) {
+                for (const std::unique_ptr<TargetSession>& target_session : app.sessions) {
+                    char label[256];
+                    snprintf(label, sizeof(label), "#%u %s (pid %llu, %s)", target_session->id,
+                             build_string(target_session->target.GetExecutable().GetFilename()).c_str(),
+                             (unsigned long long)target_session->target.GetProcess().GetProcessID(),
+                             target_session->stop_snapshot ? "stopped" : "not stopped");
+                    if (ImGui::Selectable(label, target_session.get() == session)) {
+                        select_session(app, *target_session);
+                    }
+                }
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+        ImGui::EndChild();
+    }  // end threads
+
+    {  // start stack trace
+        PROFILE_SCOPE("stack trace");
+        ImGui::BeginChild("#StackTraceChild", ImVec2(0, stack_height));
+        if (ImGui::BeginTabBar("##StackTraceTabs", ImGuiTabBarFlags_None)) {
+            if (ImGui::BeginTabItem("Stack Trace")) {
+                // the selected row is the viewed frame itself, which is reset on switching targets
+                if (stopped && ui.viewed_thread_index >= 0) {
+                    ImGui::Columns(3);
+                    ImGui::Separator();
+                    ImGui::Text("FUNCTION");
+                    ImGui::NextColumn();
+                    ImGui::Text("FILE");
+                    ImGui::NextColumn();
+                    ImGui::Text("LINE");
+                    ImGui::NextColumn();
+                    ImGui::Separator();
+
+                    const std::vector<FrameSnapshot>& frames = snapshot->threads[ui.viewed_thread_index].frames;
+                    for (size_t i = 0; i < frames.size(); i++) {
+                        const FrameSnapshot& desc = frames[i];
+
+                        if (ImGui::Selectable(desc.function_name.empty() ? "unknown" : desc.function_name.c_str(),
+                                              (int)i == ui.viewed_frame_index)) {
+                            // TODO: factor out
+                            const std::string full_path = desc.directory + desc.file_name;
+                            manually_open_and_or_focus_file(app, ui, full_path.c_str());
+                            ui.viewed_frame_index = (int)i;
+                        }
+                        ImGui::NextColumn();
+
+                        ImGui::Selectable(desc.file_name.empty() ? "unknown" : desc.file_name.c_str(),
+                                          (int)i == ui.viewed_frame_index);
+                        ImGui::NextColumn();
+
+                        static char line_buf[256];
+                        sprintf(line_buf, "%d", desc.line);
+                        ImGui::Selectable(line_buf, (int)i == ui.viewed_frame_index);
+                        ImGui::NextColumn();
+                    }
+
+                    ImGui::Columns(1);
+                }
+
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+        ImGui::EndChild();
+    }  // end stack trace
+
+    {  // start locals
+        PROFILE_SCOPE("locals");
+        ImGui::BeginChild("#LocalsChild", ImVec2(0, locals_height));
+        if (ImGui::BeginTabBar("##LocalsTabs", ImGuiTabBarFlags_None)) {
+            if (ImGui::BeginTabItem("Locals")) {
+                // TODO: turn this into a recursive tree that displays children of structs/arrays
+                if (stopped && ui.viewed_thread_index >= 0 && ui.viewed_frame_index >= 0) {
+                    lldb::SBValueList locals = frame_variables(*session, (size_t)ui.viewed_thread_index,
+                                                               (uint32_t)ui.viewed_frame_index);
+                    for (uint32_t i = 0; i < locals.GetSize(); i++) {
+                        lldb::SBValue value = locals.GetValueAtIndex(i);
+                        ImGui::TextUnformatted(value.GetName());
+
+                        ImGui::PushID((int)i);
+                        if (ImGui::BeginPopupContextItem("##WatchLocal")) {
+                            if (ImGui::MenuItem("Watch writes")) {
+                                add_watchpoint(app, value, WatchKind::Write);
+                            }
+                            if (ImGui::MenuItem("Watch reads and writes")) {
+                                add_watchpoint(app, value, WatchKind::ReadWrite);
+                            }
+                            const uint64_t address = value.GetLoadAddress();
+                            if (ImGui::MenuItem("Show in memory", nullptr, false, address != LLDB_INVALID_ADDRESS)) {
+                                show_memory(ui, address);
+                            }
+                            ImGui::EndPopup();
+                        }
+                        ImGui::PopID();
+                    }
+                }
+                ImGui::EndTabItem();
+            }
+            if (ImGui::BeginTabItem("Registers")) {
+                if (stopped && ui.viewed_thread_index >= 0) {
+                    draw_registers(*session, ui, *snapshot);
+                }
+                ImGui::EndTabItem();
+            }
+            ImGui::EndTabBar();
+        }
+        ImGui::EndChild();
+    }  // end locals
+
+    {  // start breakpoints/watchpoints
+        PROFILE_SCOPE("breakpoints");
+        ImGui::BeginChild("#BreakWatchPointChild", ImVec2(0, breakpoint_height));
+        if (ImGui::BeginTabBar("##BreakWatchPointTabs", ImGuiTabBarFlags_None)) {
+            Defer(ImGui::EndTabBar());
+
+            if (ImGui::BeginTabItem("Watchpoints")) {
+                Defer(ImGui::EndTabItem());
+                draw_watchpoints(app, ui, stopped);
+            }
+
+            if (ImGui::BeginTabItem("Breakpoints")) {
+                Defer(ImGui::EndTabItem());
+
+                draw_breakpoints(app, ui);
+            }
+        }
+        ImGui::EndChild();
+    }  // end breakpoints/watchpoints
+
+    ImGui::EndGroup();
+
+    ImGui::PopFont();
+    ImGui::End();
+
+    if (ui.show_profiler) {
+        draw_profiler(ui);
+    }
+
+    if (ui.show_sb_trace) {
+        draw_sb_trace(ui);
+    }
+
+    if (ui.show_attach) {
+        draw_attach(app, ui);
+    }
+
+    if (ui.show_open_core) {
+        draw_open_core(app, ui);
+    }
+
+    // if (app.exit_dialog) {
+    //     ImGui::SetNextWindowPos(ImVec2(window_width/2.f, window_height/2.f), ImGuiSetCond_Always);
+    //     ImGui::SetNextWindowSize(ImVec2(200, 200), ImGuiSetCond_Always);
+    //     if (ImGui::Begin("About Dear ImGui", 0, ImGuiWindowFlags_NoDecoration)) {
+    //         ImGui::TextUnformatted("asdF");
+    //     }
+    //     ImGui::End();
+    // }
+}
+
+void tick(Application& app, UserInterface& ui)
+{
+    PROFILE_SCOPE("tick");
+
+    {
+        PROFILE_SCOPE("drain log");
+        lldbg::g_logger->drain();
+    }
+
+    // F10 and F11 step over and into, holding them down keeps stepping without refreshing every pane
+    if (TargetSession* session = selected_session(app)) {
+        const ImGuiIO& io = ImGui::GetIO();
+        for (const auto& [key, kind] : {std::make_pair(256 + GLUT_KEY_F10, StepKind::Over),
+                                        std::make_pair(256 + GLUT_KEY_F11, StepKind::Into)}) {
+            const bool pressed = ImGui::IsKeyPressed(key, false);
+            const bool held = io.KeysDown[key] && io.KeysDownDuration[key] > io.KeyRepeatDelay;
+            if (pressed || (held && session->rapid_step.queued == 0)) {
+                queue_steps(app, kind, 1);
+            }
+        }
+    }
+
+    process_events(app);
+
+    // the thread and frame indices refer to the previously selected target's process
+    TargetSession* session = selected_session(app);
+    if (session) {
+        g_startup_timeline.reach(StartupMilestone::TargetCreated);
+        if (session->stop_snapshot) {
+            g_startup_timeline.reach(StartupMilestone::FirstStop);
+        }
+    }
+
+    const uint32_t session_id = session ? session->id : 0;
+    const bool switched_target = session_id != ui.viewed_session_id;
+    if (switched_target) {
+        ui.viewed_session_id = session_id;
+        ui.viewed_thread_index = -1;
+        ui.viewed_frame_index = -1;
+        ui.line_annotations.invalidate();
+    }
+
+    // keep the breakpoint markers of the viewed file in sync with breakpoints set by any means
+    const uint64_t breakpoints_version = session ? session->breakpoints.version() : 0;
+    if (switched_target || ui.breakpoints_version != breakpoints_version) {
+        const std::optional<FileReference> maybe_ref = app.open_files.focus();
+        if (maybe_ref) {
+            ui.text_editor.SetBreakpoints(breakpoint_lines(app, maybe_ref->canonical_path.string()));
+        }
+        ui.breakpoints_version = breakpoints_version;
+    }
+
+    // only rebuilt when the process stops, the breakpoints change or another file or frame is viewed
+    if (const std::optional<FileReference> ref = app.open_files.focus()) {
+        static const std::vector<BreakpointDescription> no_breakpoints;
+        const StopSnapshot* snapshot = session && session->stop_snapshot ? &*session->stop_snapshot : nullptr;
+        size_t thread_index = snapshot ? snapshot->selected_thread : 0;
+        if (ui.viewed_thread_index >= 0) {
+            thread_index = (size_t)ui.viewed_thread_index;
+        }
+        const size_t frame_index = (size_t)std::max(ui.viewed_frame_index, 0);
+        if (ui.line_annotations.update(ref->canonical_path.string(), snapshot, thread_index, frame_index,
+                                       session ? session->breakpoint_table.breakpoints() : no_breakpoints,
+                                       session ? session->breakpoint_table.version() : 0)) {
+            ui.text_editor.SetErrorMarkers(annotation_markers(ui.line_annotations));
+        }
+    }
+
+    // the only thing kept up to date while stepping rapidly is where the thread is
+    if (session && session->rapid_step.steps_taken != ui.rapid_steps_shown && session->rapid_step.location) {
+        const FrameSnapshot& location = *session->rapid_step.location;
+        ui.rapid_steps_shown = session->rapid_step.steps_taken;
+        if (!location.file_name.empty()) {
+            const std::string full_path = location.directory + location.file_name;
+            const std::optional<FileReference> focused = app.open_files.focus();
+            if (!focused || focused->canonical_path != std::filesystem::path(full_path)) {
+                manually_open_and_or_focus_file(app, ui, full_path.c_str());
+            }
+            ui.scroll_to_line = location.line;
+        }
+    }
+
+    lldbg::draw(app, ui);
+
+    std::optional<int> line_clicked = ui.text_editor.LineClicked();
+
+    if (line_clicked) {
+        add_breakpoint_to_viewed_file(app, *line_clicked);
+    }
+}
+
+void main_loop()
+{
+    lldbg::g_profiler.begin_frame();
+
+    // Start the Dear ImGui frame
+    ImGui_ImplOpenGL2_NewFrame();
+    ImGui_ImplFreeGLUT_NewFrame();
+
+    if (!lldbg::g_application && lldbg::g_pending_application.valid() &&
+        lldbg::g_pending_application.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        lldbg::g_application = lldbg::g_pending_application.get();
+    }
+
+    if (lldbg::g_application) {
+        tick(*lldbg::g_application, *lldbg::g_ui);
+    }
+    else {
+        draw_startup(*lldbg::g_ui);
+    }
+
+    // Rendering
+    {
+        PROFILE_SCOPE("ImGui::Render");
+        ImGui::Render();
+    }
+
+    {
+        PROFILE_SCOPE("OpenGL draw");
+        ImGuiIO& io = ImGui::GetIO();
+        glViewport(0, 0, (GLsizei)io.DisplaySize.x, (GLsizei)io.DisplaySize.y);
+        // glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
+        glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplOpenGL2_RenderDrawData(ImGui::GetDrawData());
+    }
+
+    {
+        PROFILE_SCOPE("swap buffers");
+        glutSwapBuffers();
+    }
+
+    glutPostRedisplay();
+
+    g_startup_timeline.reach(StartupMilestone::FirstFrame);
+    if (g_startup_timeline.elapsed_ms(StartupMilestone::FirstStop) &&
+        !g_startup_timeline.elapsed_ms(StartupMilestone::FirstUsefulFrame)) {
+        g_startup_timeline.reach(StartupMilestone::FirstUsefulFrame);
+        g_startup_timeline.log_summary();
+    }
+
+    lldbg::g_profiler.end_frame();
+    lldbg::g_sb_trace.end_frame();
+}
+
+void initialize_rendering(int* argcp, char** argv)
+{
+    // Create GLUT window
+    glutInit(argcp, argv);
+    glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_GLUTMAINLOOP_RETURNS);
+    glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_MULTISAMPLE);
+    glutInitWindowSize(1280, 720);
+    glutCreateWindow("lldbg");
+
+    // Setup GLUT display function
+    // We will also call ImGui_ImplFreeGLUT_InstallFuncs() to get all the other functions installed for us,
+    // otherwise it is possible to install our own functions and call the imgui_impl_freeglut.h functions
+    // ourselves.
+    glutDisplayFunc(main_loop);
+
+    // Setup Dear ImGui context
+    ImGui::CreateContext();
+    // ImGuiIO& io = ImGui::GetIO();
+    // io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;  // Enable Keyboard Controls
+
+    // Setup Dear ImGui style
+    ImGui::StyleColorsDark();
+    // ImGui::StyleColorsClassic();
+
+    // disable all rounding
+    ImGui::GetStyle().WindowRounding = 0.0f;
+    ImGui::GetStyle().ChildRounding = 0.0f;
+    ImGui::GetStyle().FrameRounding = 0.0f;
+    ImGui::GetStyle().GrabRounding = 0.0f;
+    ImGui::GetStyle().PopupRounding = 0.0f;
+    ImGui::GetStyle().ScrollbarRounding = 0.0f;
+    ImGui::GetStyle().TabRounding = 0.0f;
+
+    // Setup Platform/Renderer bindings
+    ImGui_ImplFreeGLUT_Init();
+    ImGui_ImplFreeGLUT_InstallFuncs();
+    ImGui_ImplOpenGL2_Init();
+}
+
+void cleanup_rendering()
+{
+    ImGui_ImplOpenGL2_Shutdown();
+    ImGui_ImplFreeGLUT_Shutdown();
+    ImGui::DestroyContext();
+}
+
+UserInterface::UserInterface(int* argcp, char** argv)
+{
+    initialize_rendering(argcp, argv);
+
+    text_editor.SetLanguageDefinition(TextEditor::LanguageDefinition::CPlusPlus());
+    TextEditor::Palette pal = text_editor.GetPalette();
+    pal[(int)TextEditor::PaletteIndex::Breakpoint] = ImGui::GetColorU32(ImVec4(255, 0, 0, 255));
+    // line annotations, translucent so that breakpoint lines stay red underneath
+    pal[(int)TextEditor::PaletteIndex::ErrorMarker] = ImGui::GetColorU32(ImVec4(1.0f, 0.75f, 0.0f, 0.35f));
+    text_editor.SetPalette(pal);
+}
+
+UserInterface::~UserInterface() { cleanup_rendering(); }
+
+void manually_open_and_or_focus_file(Application& app, UserInterface& ui, const char* filepath)
+{
+    if (app.open_files.open(std::string(filepath))) {
+        ui.request_manual_tab_change = true;
+    }
+}
+
+std::unique_ptr<Application> g_application = nullptr;
+std::unique_ptr<UserInterface> g_ui = nullptr;
+std::future<std::unique_ptr<Application>> g_pending_application;
+
+}  // namespace lldbg
+
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Application.hpp"
+#include "LineAnnotations.hpp"
+#include "LogView.hpp"
+#include "ProcessList.hpp"
+#include "TextEditor.h"
+
+#include "imgui.h"
+
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace lldbg {
+
+// Ctrl-R reverse search through the persistent command history
+struct HistorySearch {
+    bool active = false;
+    bool request_focus = false;
+    char query[256] = {};
+    std::string last_query;
+    std::optional<size_t> match;
+};
+
+struct UserInterface {
+    uint32_t viewed_session_id = 0;  // TargetSession::id, 0 when there is no target
+    int viewed_thread_index = -1;
+    int viewed_frame_index = -1;
+    int window_width = -1;
+    int window_height = -1;
+    bool request_manual_tab_change = false;
+    bool ran_command_last_frame = false;
+    HistorySearch history_search;
+    LogView log_view;
+    int log_min_level = (int)LogLevel::Verbose;
+    char log_filter[256] = {};
+    int register_lane_format = (int)LaneFormat::Hex32;
+    char watch_address[32] = {};
+    int watch_size_index = 3;  // log2 of the size in bytes
+    int watch_kind = (int)WatchKind::Write;
+    char watch_condition[256] = {};
+    std::optional<lldb::watch_id_t> selected_watchpoint;
+    char breakpoint_condition[256] = {};
+    int breakpoint_ignore_count = 0;
+    std::optional<lldb::break_id_t> selected_breakpoint;
+    char memory_address[32] = {};
+    uint64_t memory_base = 0;  // first address of the Memory pane's scrollable range
+    std::optional<uint64_t> memory_scroll_to;
+    int memory_first_row = 0;  // to tell which way the Memory pane is being scrolled
+    bool disassembly_mixed = true;
+    char disassembly_address[32] = {};
+    std::optional<uint64_t> disassembly_override;  // shown instead of the viewed frame's pc
+    uint32_t disassembly_stop_id = 0;
+    uint64_t disassembly_pc = 0;
+    bool disassembly_scroll_pending = false;
+    bool show_profiler = false;
+    bool show_sb_trace = false;
+    bool show_attach = false;
+    char attach_target[256] = {};  // a pid, or otherwise a process name
+    bool attach_wait_for_launch = false;
+    ProcessList process_list;  // only refreshed while the attach window is open
+    char process_filter[128] = {};
+    bool show_open_core = false;
+    char core_executable[1024] = {};
+    char core_file[1024] = {};
+    std::string core_error;
+    ImFont* font = nullptr;
+    TextEditor text_editor;
+    LineAnnotationCache line_annotations;  // of the viewed file, shown as the text editor's error markers
+
+    // the version of the selected target's BreakPointSet last shown in the text editor
+    uint64_t breakpoints_version = 0;
+
+    // TargetSession::RapidStep::steps_taken when its location was last shown
+    uint64_t rapid_steps_shown = 0;
+    std::optional<int> scroll_to_line;  // applied once the viewed file's text is set
+
+    static constexpr float DEFAULT_FILEBROWSER_WIDTH_PERCENT = 0.12;
+    static constexpr float DEFAULT_FILEVIEWER_WIDTH_PERCENT = 0.6;
+    static constexpr float DEFAULT_STACKTRACE_WIDTH_PERCENT = 0.28;
+
+    // kept small enough for row offsets to stay exact as float scroll positions
+    static constexpr uint64_t MEMORY_VIEW_BYTES = 4 * 1024 * 1024;
+
+    // TODO: add reset method and call when destroy/reset debug target
+
+    // Creates the GLUT window and the Dear ImGui context
+    UserInterface(int* argcp, char** argv);
+    ~UserInterface();
+
+    UserInterface(const UserInterface&) = delete;
+    UserInterface& operator=(const UserInterface&) = delete;
+    UserInterface& operator=(UserInterface&&) = delete;
+};
+
+void draw(Application& app, UserInterface& ui);
+void tick(Application& app, UserInterface& ui);
+void manually_open_and_or_focus_file(Application& app, UserInterface& ui, const char* filepath);
+
+// We only use global variables because of how freeglut
+// requires a frame update function with signature void(void).
+// They are not used anywhere other than main_loop and main.cpp
+extern std::unique_ptr<Application> g_application;
+extern std::unique_ptr<UserInterface> g_ui;
+
+// becomes g_application once LLDB is initialized, see start_application
+extern std::future<std::unique_ptr<Application>> g_pending_application;
+
+void main_loop();
+
+}  // namespace lldbg
@@ -2,29 +2,14 @@
 
 #include "Log.hpp"
 #include "Prelude.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
 
 #include <algorithm>
 #include <cstring>
 
 namespace {
 
-std::vector<std::string> read_lines(const std::filesystem::path& filepath) {
-    assert(std::filesystem::is_regular_file(filepath));
-
-    std::ifstream infile(filepath.c_str());
-
-    std::vector<std::string> contents;
-
-    std::string line;
-    while (std::getline(infile, line)) {
-        contents.push_back(line);
-    }
-
-    LOG(Debug) << "Read file from disk: " << filepath;
-
-    return contents;
-}
-
 const std::optional<std::string> validate_path(const std::string& request) {
     const std::filesystem::path canonical_path = std::filesystem::canonical(request);
 
@@ -44,6 +29,25 @@ const std::optional<std::string> validate_path(const std::string& request) {
 
 namespace lldbg {
 
+std::vector<std::string> read_lines(const std::filesystem::path& filepath)
+{
+    PROFILE_SCOPE("read_lines");
+    assert(std::filesystem::is_regular_file(filepath));
+
+    std::ifstream infile(filepath.c_str());
+
+    std::vector<std::string> contents;
+
+    std::string line;
+    while (std::getline(infile, line)) {
+        contents.push_back(line);
+    }
+
+    LOG(Debug) << "Read file from disk: " << filepath;
+
+    return contents;
+}
+
 std::unique_ptr<FileBrowserNode> FileBrowserNode::create(const std::filesystem::path& relative_path) {
 
     if (!std::filesystem::exists(relative_path)) {
@@ -75,6 +79,7 @@ std::unique_ptr<FileBrowserNode> FileBrowserNode::create(const char* relative_lo
 void FileBrowserNode::open_children()
 {
     if (!m_already_opened) {
+        PROFILE_SCOPE("FileBrowserNode::open_children");
         m_already_opened = true;
 
         for (const std::filesystem::path& p : std::filesystem::directory_iterator(m_path)) {
@@ -176,11 +181,14 @@ void OpenFiles::close(const std::string& filepath) {
 }
 
 void BreakPointSet::Synchronize(lldb::SBTarget target) {
+    PROFILE_SCOPE("BreakPointSet::Synchronize");
     m_cache.clear();
+    m_version++;
 
-    for (auto i = 0; i < target.GetNumBreakpoints(); i++) {
-        lldb::SBBreakpoint bp = target.GetBreakpointAtIndex(i);
-        lldb::SBBreakpointLocation location = bp.GetLocationAtIndex(0);
+    const uint32_t num_breakpoints = SB_CALL(Breakpoint, target.GetNumBreakpoints());
+    for (uint32_t i = 0; i < num_breakpoints; i++) {
+        lldb::SBBreakpoint bp = SB_CALL(Breakpoint, target.GetBreakpointAtIndex(i));
+        lldb::SBBreakpointLocation location = SB_CALL(Breakpoint, bp.GetLocationAtIndex(0));
 
         if (!location.IsValid()) {
             LOG(Error) << "BreakPointSet::Synchronize :: Invalid breakpoint location encountered!";
@@ -192,7 +200,7 @@ void BreakPointSet::Synchronize(lldb::SBTarget target) {
             LOG(Error) << "BreakPointSet::Synchronize :: Invalid lldb::SBAddress for breakpoint!";
         }
 
-        lldb::SBLineEntry line_entry = address.GetLineEntry();
+        lldb::SBLineEntry line_entry = SB_CALL(LineEntry, address.GetLineEntry());
 
         std::string full_path;
         full_path += build_string(line_entry.GetFileSpec().GetDirectory());
@@ -220,6 +228,7 @@ void BreakPointSet::Add(const std::string& file, int line) {
     }
 
     const std::string valid_path = *canonical_path;
+    m_version++;
 
     auto it = m_cache.find(valid_path);
 
@@ -248,6 +257,7 @@ void BreakPointSet::Remove(const std::string& file, int line) {
     } else {
         std::unordered_set<int>& breakpoints = it->second;
         breakpoints.erase(line);
+        m_version++;
     }
 }
 
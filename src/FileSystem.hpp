@@ -17,6 +17,8 @@
 
 namespace lldbg {
 
+std::vector<std::string> read_lines(const std::filesystem::path& filepath);
+
 enum class FileReadError {
     DoesNotExist,
     NotRegularFile
@@ -89,12 +91,16 @@ void OpenFiles::for_each_open_file(Callable&& f) {
 
 class BreakPointSet {
     std::unordered_map<std::string, std::unordered_set<int>> m_cache;
+    uint64_t m_version = 0;
 
 public:
     void Synchronize(lldb::SBTarget target);
     void Add(const std::string& file, int line);
     void Remove(const std::string& file, int line);
     const std::unordered_set<int> Get(const std::string& file);
+
+    // incremented on every change, so that views of the set know when to refresh
+    uint64_t version() const { return m_version; }
     size_t size(void) {
         size_t s = 0;
         for (auto& it : m_cache) {
@@ -1,6 +1,62 @@
 #include "LLDBCommandLine.hpp"
 
 #include "Log.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+struct CommandOutputSink {
+    lldbg::LineBuffer* console;
+    std::string excerpt;
+
+    void write(const char* data, size_t size)
+    {
+        console->append(data, size, (uint8_t)lldbg::ConsoleLineKind::Output);
+
+        const size_t max_excerpt = lldbg::CommandHistory::MAX_OUTPUT_EXCERPT;
+        if (excerpt.size() < max_excerpt) {
+            excerpt.append(data, std::min(size, max_excerpt - excerpt.size()));
+        }
+    }
+};
+
+// Command output is streamed straight into the console through a custom FILE*, so that
+// we never hold a second full copy of huge outputs (e.g. 'image dump symtab') as one string.
+#if defined(__APPLE__) || defined(__FreeBSD__)
+
+int write_to_sink(void* cookie, const char* data, int size)
+{
+    static_cast<CommandOutputSink*>(cookie)->write(data, (size_t)size);
+    return size;
+}
+
+FILE* open_sink_stream(CommandOutputSink* sink)
+{
+    return funopen(sink, nullptr, write_to_sink, nullptr, nullptr);
+}
+
+#else
+
+ssize_t write_to_sink(void* cookie, const char* data, size_t size)
+{
+    static_cast<CommandOutputSink*>(cookie)->write(data, size);
+    return (ssize_t)size;
+}
+
+FILE* open_sink_stream(CommandOutputSink* sink)
+{
+    cookie_io_functions_t functions = {nullptr, write_to_sink, nullptr, nullptr};
+    return fopencookie(sink, "w", functions);
+}
+
+#endif
+
+}  // namespace
 
 namespace lldbg {
 
@@ -11,31 +67,67 @@ bool LLDBCommandLine::run_command(const char* command, bool hide_from_history)
         return false;
     }
 
-    CommandLineEntry entry;
-    entry.input = std::string(command);
+    CommandOutputSink sink = {&m_history, std::string()};
+    FILE* output_stream = nullptr;
+
+    if (!hide_from_history) {
+        m_history.begin_record();
+        m_history.append("> ", 2, (uint8_t)ConsoleLineKind::Input);
+        m_history.append(command, strlen(command), (uint8_t)ConsoleLineKind::Input);
+        m_history.flush();
 
-    lldb::SBCommandReturnObject ret;
-    m_interpreter.HandleCommand(command, ret);
+        output_stream = open_sink_stream(&sink);
 
-    if (ret.GetOutput()) {
-        entry.output = std::string(ret.GetOutput());
+        if (!output_stream) {
+            LOG(Warning) << "Failed to open streaming output for command, falling back to buffered output.";
+        }
     }
 
-    entry.succeeded = ret.Succeeded();
+    bool succeeded = false;
+    std::string error_msg;
+
+    {
+        lldb::SBCommandReturnObject ret;
+
+        if (output_stream) {
+            ret.SetImmediateOutputFile(output_stream);
+        }
+
+        {
+            PROFILE_SCOPE("SBCommandInterpreter::HandleCommand");
+            SB_CALL(Command, m_interpreter.HandleCommand(command, ret));
+        }
 
-    if (!entry.succeeded) {
-        if (ret.GetError()) {
-            entry.error_msg = std::string(ret.GetError());
-        } else {
-            entry.error_msg = "Unknown failure reason!";
+        if (!hide_from_history && !output_stream && ret.GetOutput()) {
+            sink.write(ret.GetOutput(), ret.GetOutputSize());
         }
+
+        succeeded = ret.Succeeded();
+
+        if (!succeeded) {
+            error_msg = ret.GetError() ? std::string(ret.GetError()) : "Unknown failure reason!";
+        }
+    }
+
+    // closing the stream flushes any output still sitting in the stdio buffer
+    if (output_stream) {
+        fclose(output_stream);
     }
 
     if (!hide_from_history) {
-        m_history.emplace_back(entry);
+        m_history.flush();
+
+        if (!succeeded) {
+            m_history.append(error_msg.data(), error_msg.size(), (uint8_t)ConsoleLineKind::Error);
+            m_history.flush();
+        }
+
+        m_history.append("\n", 1, (uint8_t)ConsoleLineKind::Output);
+
+        m_persistent_history.record(command, succeeded ? sink.excerpt : error_msg);
     }
 
-    return ret.Succeeded();
+    return succeeded;
 }
 
 }
@@ -2,22 +2,27 @@
 
 #include "lldb/API/LLDB.h"
 
-#include <vector>
+#include "CommandHistory.hpp"
+#include "LineBuffer.hpp"
+
+#include <cstdint>
 #include <string>
 
 namespace lldbg {
 
-struct CommandLineEntry final {
-    std::string input;
-    std::string output;
-    std::optional<std::string> error_msg;
-    bool succeeded;
-};
+// Stored as the LineBuffer tag of each line of the console history
+enum class ConsoleLineKind : uint8_t { Output, Input, Error };
 
 class LLDBCommandLine final {
+    // Upper bounds on the memory held by the console, the oldest commands are dropped first
+    static constexpr size_t MAX_HISTORY_BYTES = 64 * 1024 * 1024;
+    static constexpr size_t MAX_HISTORY_LINES = 1024 * 1024;
+
     lldb::SBCommandInterpreter m_interpreter;
-    std::vector<CommandLineEntry> m_history;
+    LineBuffer m_history;
+    CommandHistory m_persistent_history;
 public:
+    LLDBCommandLine() : m_history(MAX_HISTORY_BYTES, MAX_HISTORY_LINES) {}
 
     void replace_interpreter(lldb::SBCommandInterpreter interpreter) {
         m_interpreter = interpreter;
@@ -26,7 +31,13 @@ public:
 
     bool run_command(const char* command, bool hide_from_history = false);
 
-    const std::vector<CommandLineEntry>& get_history() const { return m_history; }
+    const LineBuffer& get_history() const { return m_history; }
+
+    // Unlike the console output, the persistent history survives replace_interpreter and restarts
+    void open_persistent_history(const std::filesystem::path& project_directory) {
+        m_persistent_history.open_project(project_directory);
+    }
+    CommandHistory& get_persistent_history() { return m_persistent_history; }
 };
 
 }
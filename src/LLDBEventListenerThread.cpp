@@ -14,39 +14,47 @@ LLDBEventListenerThread::LLDBEventListenerThread()
 { }
 
 
+namespace {
+
+const uint32_t PROCESS_EVENTS = lldb::SBProcess::eBroadcastBitStateChanged
+                              | lldb::SBProcess::eBroadcastBitSTDOUT
+                              | lldb::SBProcess::eBroadcastBitSTDERR;
+
+// breakpoints and watchpoints added, removed or modified, including through the console
+const uint32_t TARGET_EVENTS = lldb::SBTarget::eBroadcastBitBreakpointChanged
+                             | lldb::SBTarget::eBroadcastBitWatchpointChanged;
+
+}
+
 //TODO: rename to start_listening and stop_listening to separate better from start/stop of debugger
 void LLDBEventListenerThread::start(lldb::SBDebugger& debugger) {
+    if (m_thread) {
+        return;
+    }
 
     m_listener = debugger.GetListener();
 
-    const uint32_t listen_flags = lldb::SBProcess::eBroadcastBitStateChanged
-                                | lldb::SBProcess::eBroadcastBitSTDOUT
-                                | lldb::SBProcess::eBroadcastBitSTDERR;
-
-    //TODO: when will we have to deal with multiple targets/processes?
-    debugger.GetSelectedTarget()
-            .GetProcess()
-            .GetBroadcaster()
-            .AddListener(m_listener, listen_flags);
+    // listening by broadcaster class covers every target and process, including ones created later
+    m_listener.StartListeningForEventClass(debugger, lldb::SBProcess::GetBroadcasterClassName(), PROCESS_EVENTS);
+    m_listener.StartListeningForEventClass(debugger, lldb::SBTarget::GetBroadcasterClassName(), TARGET_EVENTS);
 
     m_continue.store(true);
-
-    if (!m_thread) {
-        m_thread.reset(new std::thread(&LLDBEventListenerThread::poll_events, this));
-    }
+    m_thread.reset(new std::thread(&LLDBEventListenerThread::poll_events, this));
 
     LOG(Debug) << "Successfully launched LLDBEventListenerThread.";
 }
 
 void LLDBEventListenerThread::stop(lldb::SBDebugger& debugger) {
+    if (!m_thread) {
+        return;
+    }
+
     m_continue.store(false);
     m_thread->join();
     m_thread.reset(nullptr);
 
-    debugger.GetSelectedTarget()
-            .GetProcess()
-            .GetBroadcaster()
-            .RemoveListener(m_listener);
+    m_listener.StopListeningForEventClass(debugger, lldb::SBProcess::GetBroadcasterClassName(), PROCESS_EVENTS);
+    m_listener.StopListeningForEventClass(debugger, lldb::SBTarget::GetBroadcasterClassName(), TARGET_EVENTS);
 
     m_listener.Clear();
 
@@ -2,18 +2,22 @@
 
 #include "Prelude.hpp"
 
+#include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 
 #include "lldb/API/LLDB.h"
 
-namespace {
+namespace lldbg {
 
 // A simple thread-safe queue for LLDB events
 class EventQueue final {
     std::mutex m_mutex;
+    std::condition_variable m_pushed;
     std::deque<lldb::SBEvent> m_events;
 
 public:
@@ -23,8 +27,11 @@ public:
     }
 
     void push(const lldb::SBEvent& new_event) {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_events.push_back(new_event);
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_events.push_back(new_event);
+        }
+        m_pushed.notify_one();
     }
 
     std::optional<lldb::SBEvent> pop(void) {
@@ -39,16 +46,25 @@ public:
         }
     }
 
+    // Blocks until an event is available or the timeout expires
+    std::optional<lldb::SBEvent> wait_pop(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (!m_pushed.wait_for(lock, timeout, [this] { return !m_events.empty(); })) {
+            return {};
+        }
+
+        lldb::SBEvent oldest_event = m_events.front();
+        m_events.pop_front();
+        return oldest_event;
+    }
+
     void clear(void) {
         std::unique_lock<std::mutex> lock(m_mutex);
         m_events.clear();
     }
 };
 
-}
-
-namespace lldbg {
-
 // A pollable thread for collecting LLDB events from a queue
 class LLDBEventListenerThread final {
     lldb::SBListener m_listener;
@@ -62,6 +78,7 @@ public:
     void start(lldb::SBDebugger&);
     void stop(lldb::SBDebugger&);
     std::optional<lldb::SBEvent> pop_event() { return m_events.pop(); }
+    std::optional<lldb::SBEvent> wait_event(std::chrono::milliseconds timeout) { return m_events.wait_pop(timeout); }
 
     LLDBEventListenerThread();
 
@@ -0,0 +1,136 @@
+#include "LineAnnotations.hpp"
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+namespace lldbg {
+
+bool LineAnnotationCache::same_file(const std::string& directory, const std::string& file_name)
+{
+    if (file_name != m_file_name) {
+        return false;
+    }
+
+    // only canonicalized once per directory, as it touches the file system
+    auto it = m_directory_matches.find(directory);
+    if (it == m_directory_matches.end()) {
+        const std::string full_path = directory + file_name;
+        bool matches = full_path == m_path;
+        if (!matches) {
+            std::error_code error;
+            const std::filesystem::path canonical_path = std::filesystem::canonical(full_path, error);
+            matches = !error && canonical_path.string() == m_path;
+        }
+        it = m_directory_matches.emplace(directory, matches).first;
+    }
+    return it->second;
+}
+
+bool LineAnnotationCache::update(const std::string& canonical_path, const StopSnapshot* snapshot,
+                                 size_t thread_index, size_t frame_index,
+                                 const std::vector<BreakpointDescription>& breakpoints, uint64_t breakpoints_version)
+{
+    const uint32_t stop_id = snapshot ? snapshot->stop_id : 0;
+    const bool viewed_thread_loaded =
+        snapshot && thread_index < snapshot->threads.size() && snapshot->threads[thread_index].frames_loaded;
+    if (m_built && canonical_path == m_path && stop_id == m_stop_id && breakpoints_version == m_breakpoints_version &&
+        thread_index == m_thread_index && frame_index == m_frame_index &&
+        viewed_thread_loaded == m_viewed_thread_loaded) {
+        return false;
+    }
+
+    PROFILE_SCOPE("LineAnnotationCache::update");
+
+    if (canonical_path != m_path) {
+        m_path = canonical_path;
+        m_file_name = std::filesystem::path(canonical_path).filename().string();
+        m_directory_matches.clear();
+    }
+    m_stop_id = stop_id;
+    m_breakpoints_version = breakpoints_version;
+    m_thread_index = thread_index;
+    m_frame_index = frame_index;
+    m_viewed_thread_loaded = viewed_thread_loaded;
+    m_built = true;
+    m_version++;
+
+    // one entry per thing on a line, merged once sorted
+    std::vector<LineAnnotation> entries;
+
+    if (snapshot) {
+        for (size_t i = 0; i < snapshot->threads.size(); i++) {
+            const ThreadSnapshot& thread = snapshot->threads[i];
+            if (thread.frames.empty()) {
+                continue;  // not walked yet, see StopSnapshot::load_frames
+            }
+
+            const FrameSnapshot& innermost = thread.frames.front();
+            if (innermost.line > 0 && same_file(innermost.directory, innermost.file_name)) {
+                LineAnnotation entry;
+                entry.line = innermost.line;
+                entry.thread_ids.push_back(thread.index_id);
+                entries.push_back(std::move(entry));
+            }
+
+            if (i == thread_index && frame_index < thread.frames.size()) {
+                const FrameSnapshot& viewed = thread.frames[frame_index];
+                if (viewed.line > 0 && same_file(viewed.directory, viewed.file_name)) {
+                    LineAnnotation entry;
+                    entry.line = viewed.line;
+                    entry.viewed_frame = true;
+                    entries.push_back(std::move(entry));
+                }
+            }
+        }
+    }
+
+    for (const BreakpointDescription& breakpoint : breakpoints) {
+        if (breakpoint.line > 0 && same_file(breakpoint.directory, breakpoint.file_name)) {
+            LineAnnotation entry;
+            entry.line = breakpoint.line;
+            entry.breakpoints.push_back(breakpoint.id);
+            entry.breakpoint_hits = breakpoint.hit_count;
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const LineAnnotation& a, const LineAnnotation& b) { return a.line < b.line; });
+
+    m_annotations.clear();
+    for (LineAnnotation& entry : entries) {
+        if (m_annotations.empty() || m_annotations.back().line != entry.line) {
+            m_annotations.push_back(std::move(entry));
+            continue;
+        }
+
+        LineAnnotation& annotation = m_annotations.back();
+        annotation.viewed_frame = annotation.viewed_frame || entry.viewed_frame;
+        annotation.thread_ids.insert(annotation.thread_ids.end(), entry.thread_ids.begin(), entry.thread_ids.end());
+        annotation.breakpoints.insert(annotation.breakpoints.end(), entry.breakpoints.begin(),
+                                      entry.breakpoints.end());
+        annotation.breakpoint_hits += entry.breakpoint_hits;
+    }
+
+    return true;
+}
+
+std::pair<const LineAnnotation*, const LineAnnotation*> LineAnnotationCache::range(int first, int last) const
+{
+    auto by_line = [](const LineAnnotation& annotation, int line) { return annotation.line < line; };
+    auto begin = std::lower_bound(m_annotations.begin(), m_annotations.end(), first, by_line);
+    auto end = std::lower_bound(begin, m_annotations.end(), last + 1, by_line);
+    const LineAnnotation* data = m_annotations.data();
+    return {data + (begin - m_annotations.begin()), data + (end - m_annotations.begin())};
+}
+
+const LineAnnotation* LineAnnotationCache::find(int line) const
+{
+    const std::pair<const LineAnnotation*, const LineAnnotation*> found = range(line, line);
+    return found.first != found.second ? found.first : nullptr;
+}
+
+}  // namespace lldbg
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Breakpoints.hpp"
+#include "StopSnapshot.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lldbg {
+
+// Everything worth marking on one line of a source file
+struct LineAnnotation {
+    int line = 0;                      // 1-based
+    bool viewed_frame = false;         // the viewed frame is stopped at this line
+    std::vector<uint32_t> thread_ids;  // ThreadSnapshot::index_id of threads whose innermost frame is here
+    std::vector<lldb::break_id_t> breakpoints;
+    uint32_t breakpoint_hits = 0;
+};
+
+// Where the stopped threads and the breakpoints are in the viewed file, sorted by line. Built once
+// per stop (or breakpoint change, or change of viewed file or frame) by scanning every thread, so
+// that drawing the file only has to look up its visible lines.
+class LineAnnotationCache final {
+    std::string m_path;  // canonical
+    std::string m_file_name;
+    std::unordered_map<std::string, bool> m_directory_matches;  // of frames whose file name matches
+
+    uint32_t m_stop_id = 0;
+    uint64_t m_breakpoints_version = 0;
+    size_t m_thread_index = 0;
+    size_t m_frame_index = 0;
+    bool m_viewed_thread_loaded = false;  // core file stacks are walked when first viewed
+    bool m_built = false;
+
+    std::vector<LineAnnotation> m_annotations;
+    uint64_t m_version = 0;
+
+    bool same_file(const std::string& directory, const std::string& file_name);
+
+public:
+    // Rebuilds the annotations of the file if anything they depend on changed, returns whether it did.
+    // The snapshot may be null while the process runs, leaving only breakpoints.
+    bool update(const std::string& canonical_path, const StopSnapshot* snapshot, size_t thread_index,
+                size_t frame_index, const std::vector<BreakpointDescription>& breakpoints,
+                uint64_t breakpoints_version);
+
+    void invalidate() { m_built = false; }
+
+    const std::vector<LineAnnotation>& annotations() const { return m_annotations; }
+
+    // the annotations of lines first to last inclusive, found by binary search
+    std::pair<const LineAnnotation*, const LineAnnotation*> range(int first, int last) const;
+    const LineAnnotation* find(int line) const;
+
+    // incremented on every rebuild
+    uint64_t version() const { return m_version; }
+};
+
+}  // namespace lldbg
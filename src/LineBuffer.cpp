@@ -0,0 +1,141 @@
+#include "LineBuffer.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace lldbg {
+
+const char* LineBuffer::store(const char* data, size_t length)
+{
+    if (length > CHUNK_SIZE) {
+        // oversized lines get a dedicated chunk rather than splitting them across chunks
+        std::unique_ptr<char[]> chunk(new char[length]);
+        memcpy(chunk.get(), data, length);
+        m_chunks.emplace_back(std::move(chunk));
+        m_chunk_used = CHUNK_SIZE;
+        return m_chunks.back().get();
+    }
+
+    if (m_chunks.empty() || m_chunk_used + length > CHUNK_SIZE) {
+        m_chunks.emplace_back(new char[CHUNK_SIZE]);
+        m_chunk_used = 0;
+    }
+
+    char* destination = m_chunks.back().get() + m_chunk_used;
+    memcpy(destination, data, length);
+    m_chunk_used += length;
+    return destination;
+}
+
+void LineBuffer::push_line(const char* data, size_t length, uint8_t tag)
+{
+    if (length > 0 && data[length - 1] == '\r') {
+        length--;
+    }
+
+    if (length > std::numeric_limits<uint32_t>::max()) {
+        length = std::numeric_limits<uint32_t>::max();
+    }
+
+    const char* begin = store(data, length);
+    const uint32_t chunk_id = m_first_chunk_id + (uint32_t)m_chunks.size() - 1;
+
+    m_lines.push_back({begin, (uint32_t)length, chunk_id, tag, m_next_line_starts_record});
+    if (m_next_line_starts_record) {
+        m_record_count++;
+        m_next_line_starts_record = false;
+    }
+    m_byte_count += length;
+
+    evict();
+}
+
+void LineBuffer::pop_front_line()
+{
+    m_byte_count -= m_lines.front().length;
+    if (m_lines.front().record_start) {
+        m_record_count--;
+    }
+    m_lines.pop_front();
+}
+
+void LineBuffer::evict()
+{
+    if (m_byte_count <= m_max_bytes && m_lines.size() <= m_max_lines) {
+        return;
+    }
+
+    while (!m_lines.empty() && (m_byte_count > m_max_bytes || m_lines.size() > m_max_lines)) {
+        pop_front_line();
+    }
+
+    // Only keep complete records, unless the record currently being written is the only
+    // one left (e.g. a single enormous command output), in which case we keep its tail.
+    while (m_record_count > 0 && !m_lines.front().record_start) {
+        pop_front_line();
+    }
+
+    // release chunks that no longer back any line, but never the one being written into
+    while (m_chunks.size() > 1 && (m_lines.empty() || m_lines.front().chunk_id != m_first_chunk_id)) {
+        m_chunks.pop_front();
+        m_first_chunk_id++;
+    }
+}
+
+void LineBuffer::begin_record()
+{
+    flush();
+    m_next_line_starts_record = true;
+}
+
+void LineBuffer::append(const char* data, size_t length, uint8_t tag)
+{
+    const char* const end = data + length;
+
+    if (!m_partial_line.empty() && m_partial_tag != tag) {
+        flush();
+    }
+
+    while (data < end) {
+        const char* newline = static_cast<const char*>(memchr(data, '\n', end - data));
+
+        if (!newline) {
+            m_partial_line.append(data, end - data);
+            m_partial_tag = tag;
+            return;
+        }
+
+        if (m_partial_line.empty()) {
+            push_line(data, newline - data, tag);
+        }
+        else {
+            m_partial_line.append(data, newline - data);
+            push_line(m_partial_line.data(), m_partial_line.size(), tag);
+            m_partial_line.clear();
+        }
+
+        data = newline + 1;
+    }
+}
+
+void LineBuffer::flush()
+{
+    if (!m_partial_line.empty()) {
+        push_line(m_partial_line.data(), m_partial_line.size(), m_partial_tag);
+        m_partial_line.clear();
+    }
+}
+
+void LineBuffer::clear()
+{
+    m_chunks.clear();
+    m_first_chunk_id = 0;
+    m_chunk_used = CHUNK_SIZE;
+    m_byte_count = 0;
+    m_lines.clear();
+    m_record_count = 0;
+    m_partial_line.clear();
+    m_next_line_starts_record = false;
+}
+
+}  // namespace lldbg
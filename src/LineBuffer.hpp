@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace lldbg {
+
+// Append-only, capacity-bounded text storage for (potentially enormous) console output.
+// Text is copied into fixed size chunks that are never reallocated, and every complete
+// line is indexed, so a single line can be fetched in O(1) for virtualized rendering.
+// Once either capacity is exceeded the oldest records are dropped and their chunks released.
+class LineBuffer final {
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    struct Line {
+        const char* begin;
+        uint32_t length;
+        uint32_t chunk_id;
+        uint8_t tag;
+        bool record_start;
+    };
+
+    const size_t m_max_bytes;
+    const size_t m_max_lines;
+
+    std::deque<std::unique_ptr<char[]>> m_chunks;
+    uint32_t m_first_chunk_id = 0;
+    size_t m_chunk_used = CHUNK_SIZE;
+    size_t m_byte_count = 0;
+
+    std::deque<Line> m_lines;
+    size_t m_record_count = 0;
+    std::string m_partial_line;
+    uint8_t m_partial_tag = 0;
+    bool m_next_line_starts_record = false;
+
+    const char* store(const char* data, size_t length);
+    void push_line(const char* data, size_t length, uint8_t tag);
+    void pop_front_line();
+    void evict();
+
+public:
+    LineBuffer(size_t max_bytes = SIZE_MAX, size_t max_lines = SIZE_MAX)
+        : m_max_bytes(max_bytes), m_max_lines(max_lines)
+    {}
+
+    LineBuffer(const LineBuffer&) = delete;
+    LineBuffer& operator=(const LineBuffer&) = delete;
+
+    // Marks the next appended line as the start of a new logical record (e.g. a console
+    // command). Eviction never leaves a partial record at the front of the buffer.
+    void begin_record();
+    void append(const char* data, size_t length, uint8_t tag = 0);
+    void flush();
+    void clear();
+
+    size_t line_count() const { return m_lines.size(); }
+    size_t byte_count() const { return m_byte_count; }
+    bool empty() const { return m_lines.empty() && m_partial_line.empty(); }
+
+    const char* line_begin(size_t index) const { return m_lines[index].begin; }
+    const char* line_end(size_t index) const { return m_lines[index].begin + m_lines[index].length; }
+    uint8_t line_tag(size_t index) const { return m_lines[index].tag; }
+};
+
+}  // namespace lldbg
@@ -1,5 +1,151 @@
 #include "Log.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::atomic<uint64_t> s_next_logger_id = {1};
+
+// The buffer the current thread logs into, tagged with the logger it belongs to so that a
+// freshly created logger never sees a buffer owned by a destroyed one.
+struct ThreadLocalBuffer {
+    uint64_t logger_id = 0;
+    std::shared_ptr<lldbg::ThreadLogBuffer> buffer;
+
+    ~ThreadLocalBuffer()
+    {
+        if (buffer) {
+            buffer->release();
+        }
+    }
+};
+
+thread_local ThreadLocalBuffer t_buffer;
+
+}  // namespace
+
 namespace lldbg {
+
 std::unique_ptr<Logger> g_logger = nullptr;
+
+const char* log_level_name(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::Verbose:
+            return "Verbose";
+        case LogLevel::Debug:
+            return "Debug";
+        case LogLevel::Info:
+            return "Info";
+        case LogLevel::Warning:
+            return "Warning";
+        case LogLevel::Error:
+            return "Error";
+    }
+    return "Unknown";
+}
+
+void ThreadLogBuffer::push(LogLevel level, uint64_t timestamp_ns, const char* text, size_t length)
+{
+    const uint64_t head = m_head.load(std::memory_order_relaxed);
+
+    if (head - m_tail.load(std::memory_order_acquire) == CAPACITY) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = m_records[head % CAPACITY];
+    record.timestamp_ns = timestamp_ns;
+    record.level = level;
+    record.length = (uint16_t)std::min(length, TEXT_CAPACITY);
+    memcpy(record.text, text, record.length);
+
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+Logger::Logger(LogLevel min_level)
+    : m_id(s_next_logger_id.fetch_add(1)), m_start_ns(now_ns()), m_min_level((int)min_level)
+{
+    m_recent.resize(MAX_RECENT_MESSAGES);
 }
+
+ThreadLogBuffer& Logger::this_thread_buffer()
+{
+    if (t_buffer.logger_id != m_id) {
+        if (t_buffer.buffer) {
+            t_buffer.buffer->release();  // of a previous logger
+        }
+
+        std::unique_lock<std::mutex> lock(m_registry_mutex);
+        const uint32_t thread_id = m_next_thread_id++;
+
+        auto reusable = std::find_if(m_thread_buffers.begin(), m_thread_buffers.end(),
+                                     [](const std::shared_ptr<ThreadLogBuffer>& buffer) { return buffer->reusable(); });
+        if (reusable != m_thread_buffers.end()) {
+            (*reusable)->reuse(thread_id);
+            t_buffer.buffer = *reusable;
+        }
+        else {
+            m_thread_buffers.push_back(std::make_shared<ThreadLogBuffer>(thread_id));
+            t_buffer.buffer = m_thread_buffers.back();
+        }
+        t_buffer.logger_id = m_id;
+    }
+
+    return *t_buffer.buffer;
+}
+
+void Logger::log(LogLevel level, const char* text, size_t length)
+{
+    this_thread_buffer().push(level, now_ns() - m_start_ns, text, length);
+}
+
+void Logger::store(LogMessage&& message)
+{
+    m_recent[m_total_messages % MAX_RECENT_MESSAGES] = std::move(message);
+    m_total_messages++;
+}
+
+void Logger::drain()
+{
+    std::vector<LogMessage> pending;
+
+    {
+        std::unique_lock<std::mutex> lock(m_registry_mutex);
+        for (const std::shared_ptr<ThreadLogBuffer>& buffer : m_thread_buffers) {
+            buffer->drain([&](const ThreadLogBuffer::Record& record) {
+                pending.push_back(
+                    {record.level, buffer->thread_id, record.timestamp_ns, std::string(record.text, record.length)});
+            });
+
+            const uint64_t dropped = buffer->take_dropped_count();
+            if (dropped > 0) {
+                pending.push_back({LogLevel::Warning, buffer->thread_id, now_ns() - m_start_ns,
+                                   std::to_string(dropped) + " log messages dropped (thread buffer full)"});
+            }
+        }
+    }
+
+    if (pending.empty()) {
+        return;
+    }
+
+    std::stable_sort(pending.begin(), pending.end(), [](const LogMessage& a, const LogMessage& b) {
+        return a.timestamp_ns < b.timestamp_ns;
+    });
+
+    for (LogMessage& message : pending) {
+        store(std::move(message));
+    }
+}
+
+}  // namespace lldbg
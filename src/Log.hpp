@@ -1,66 +1,184 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <sstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
 #include <vector>
 
-#define LOG(LEV) lldbg::LogMessageStream(lldbg::LogLevel::LEV)
+// Messages below the logger's minimum level are discarded before any formatting happens,
+// so a filtered out LOG(...) costs one relaxed atomic load.
+#define LOG(LEV)                                          \
+    if (!lldbg::log_enabled(lldbg::LogLevel::LEV)) {      \
+    }                                                     \
+    else                                                  \
+        lldbg::LogMessageStream(lldbg::LogLevel::LEV)
 
 namespace lldbg {
 
 enum class LogLevel { Verbose, Debug, Info, Warning, Error };
 
+const char* log_level_name(LogLevel level);
+
 struct LogMessage final {
-    const LogLevel level;
-    const std::string message;
+    LogLevel level;
+    uint32_t thread_id;      // small sequential id, in order of each thread's first message
+    uint64_t timestamp_ns;   // since the logger was created
+    std::string message;
+};
+
+// A fixed capacity single-producer/single-consumer ring of log records, one per logging thread.
+// The owning thread pushes without ever taking a lock, Logger::drain is the only consumer.
+// When the owning thread exits the buffer is released, and handed to the next new logging thread
+// once drained, so that short-lived threads (std::async tasks) don't each keep one forever.
+class ThreadLogBuffer final {
+public:
+    static constexpr size_t CAPACITY = 1024;
+    static constexpr size_t TEXT_CAPACITY = 232;
+
+    struct Record {
+        uint64_t timestamp_ns;
+        LogLevel level;
+        uint16_t length;
+        char text[TEXT_CAPACITY];
+    };
+
+private:
+    std::array<Record, CAPACITY> m_records;
+    std::atomic<uint64_t> m_head = {0};
+    std::atomic<uint64_t> m_tail = {0};
+    std::atomic<uint64_t> m_dropped = {0};
+    std::atomic<bool> m_released = {false};
+
+public:
+    uint32_t thread_id;  // only changed by Logger under its registry mutex, when the buffer is reused
+
+    explicit ThreadLogBuffer(uint32_t thread_id) : thread_id(thread_id) {}
+
+    // called by the owning thread as it exits, it must not push anymore
+    void release() { m_released.store(true, std::memory_order_release); }
+
+    // released and with nothing left for drain to pick up
+    bool reusable() const
+    {
+        return m_released.load(std::memory_order_acquire) &&
+               m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed) &&
+               m_dropped.load(std::memory_order_relaxed) == 0;
+    }
+
+    void reuse(uint32_t new_thread_id)
+    {
+        thread_id = new_thread_id;
+        m_released.store(false, std::memory_order_relaxed);
+    }
+
+    void push(LogLevel level, uint64_t timestamp_ns, const char* text, size_t length);
+
+    template <typename Callable>
+    void drain(Callable&& f);
 
-    LogMessage(LogLevel level, const std::string& message) : level(level), message(message) {}
+    uint64_t take_dropped_count() { return m_dropped.exchange(0, std::memory_order_relaxed); }
 };
 
+template <typename Callable>
+void ThreadLogBuffer::drain(Callable&& f)
+{
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    const uint64_t head = m_head.load(std::memory_order_acquire);
+
+    for (; tail != head; tail++) {
+        f(m_records[tail % CAPACITY]);
+    }
+
+    m_tail.store(tail, std::memory_order_release);
+}
+
+// Any thread may log. Only one thread, the consumer (the render loop, or the main thread of the
+// headless tools), may drain and read the retained messages, which is why those are not locked.
 class Logger final {
-    std::mutex m_mutex;
-    std::vector<LogMessage> m_messages;
+    // Only the most recent messages are retained, the oldest are overwritten first
+    static constexpr size_t MAX_RECENT_MESSAGES = 128 * 1024;
+
+    const uint64_t m_id;
+    const uint64_t m_start_ns;
+    std::atomic<int> m_min_level;
+
+    // only taken once per thread (registration) and by consumers, never on the logging path.
+    // Buffers are shared with the threads logging into them, which may outlive the logger.
+    std::mutex m_registry_mutex;
+    std::vector<std::shared_ptr<ThreadLogBuffer>> m_thread_buffers;
+    uint32_t m_next_thread_id = 0;
+
+    // only touched by the consumer thread, see drain
+    std::vector<LogMessage> m_recent;
+    uint64_t m_total_messages = 0;
+
+    ThreadLogBuffer& this_thread_buffer();
+    void store(LogMessage&& message);
 
 public:
-    void log(LogLevel level, const std::string& message)
+    Logger(LogLevel min_level = LogLevel::Debug);
+
+    bool enabled(LogLevel level) const { return (int)level >= m_min_level.load(std::memory_order_relaxed); }
+    void set_min_level(LogLevel level) { m_min_level.store((int)level, std::memory_order_relaxed); }
+    LogLevel min_level() const { return (LogLevel)m_min_level.load(std::memory_order_relaxed); }
+
+    void log(LogLevel level, const char* text, size_t length);
+
+    // Moves all pending messages from the per-thread buffers into the ring of recent messages,
+    // ordered by timestamp. Should be called regularly (once per frame) by a single consumer thread,
+    // which is also the only one that may read the retained messages below: they aren't locked.
+    void drain();
+
+    // Sequence numbers of the retained messages are [first_message_index(), message_count())
+    uint64_t message_count() const { return m_total_messages; }
+    uint64_t first_message_index() const
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_messages.emplace_back(level, message);
-    };
+        return m_total_messages > MAX_RECENT_MESSAGES ? m_total_messages - MAX_RECENT_MESSAGES : 0;
+    }
+    const LogMessage& message(uint64_t index) const { return m_recent[index % MAX_RECENT_MESSAGES]; }
 
-    // TODO: just do begin/end
     template <typename Callable>
     void for_each_message(Callable&& f)
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
-        for (const LogMessage& message : m_messages) {
-            f(message);
+        drain();
+        for (uint64_t i = first_message_index(); i < m_total_messages; i++) {
+            f(message(i));
         }
     }
 };
 
 extern std::unique_ptr<Logger> g_logger;
 
+inline bool log_enabled(LogLevel level) { return g_logger && g_logger->enabled(level); }
+
 class LogMessageStream final {
+    // streams into a fixed buffer on the stack, silently truncating overly long messages
+    class FixedBuffer final : public std::streambuf {
+    public:
+        FixedBuffer(char* begin, size_t size) { setp(begin, begin + size); }
+        size_t size() const { return pptr() - pbase(); }
+    };
+
     const LogLevel level;
-    std::ostringstream oss;
+    char m_text[ThreadLogBuffer::TEXT_CAPACITY];
+    FixedBuffer m_buffer;
+    std::ostream m_stream;
 
 public:
     template <typename T>
     LogMessageStream& operator<<(const T& data)
     {
-        oss << data;
+        m_stream << data;
         return *this;
     }
 
-    LogMessageStream(LogLevel level) : level(level) {}
-    ~LogMessageStream()
-    {
-        oss << std::endl;
-        g_logger->log(level, oss.str());
-    };
+    LogMessageStream(LogLevel level) : level(level), m_buffer(m_text, sizeof(m_text)), m_stream(&m_buffer) {}
+    ~LogMessageStream() { g_logger->log(level, m_text, m_buffer.size()); };
 };
 
 }  // namespace lldbg
-
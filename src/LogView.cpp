@@ -0,0 +1,105 @@
+#include "LogView.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+char to_lower(char c) { return (char)std::tolower((unsigned char)c); }
+
+}  // namespace
+
+namespace lldbg {
+
+bool LogView::matches_query(const LogMessage& message) const
+{
+    if (m_query.empty()) {
+        return true;
+    }
+
+    return std::search(message.message.begin(), message.message.end(), m_query.begin(), m_query.end(),
+                       [](char a, char b) { return to_lower(a) == b; }) != message.message.end();
+}
+
+void LogView::update(const Logger& logger)
+{
+    const uint64_t first = logger.first_message_index();
+    const uint64_t count = logger.message_count();
+
+    // forget messages that have been overwritten in the logger's ring
+    for (std::deque<uint64_t>& indices : m_by_level) {
+        while (!indices.empty() && indices.front() < first) {
+            indices.pop_front();
+        }
+    }
+    while (!m_matches.empty() && m_matches.front() < first) {
+        m_matches.pop_front();
+    }
+
+    for (uint64_t i = std::max(m_next_message, first); i < count; i++) {
+        const LogMessage& message = logger.message(i);
+        m_by_level[(size_t)message.level].push_back(i);
+        m_total_by_level[(size_t)message.level]++;
+
+        if (message.level >= m_min_level && matches_query(message)) {
+            m_matches.push_back(i);
+        }
+    }
+
+    m_next_message = count;
+}
+
+void LogView::set_filter(const Logger& logger, LogLevel min_level, const std::string& query)
+{
+    std::string lowercase_query = query;
+    std::transform(lowercase_query.begin(), lowercase_query.end(), lowercase_query.begin(), to_lower);
+
+    if (min_level == m_min_level && lowercase_query == m_query) {
+        return;
+    }
+
+    const bool narrowing = min_level == m_min_level && lowercase_query.find(m_query) != std::string::npos;
+
+    m_min_level = min_level;
+    m_query = lowercase_query;
+
+    if (narrowing) {
+        // every match of the new query is also a match of the old one
+        m_matches.erase(std::remove_if(m_matches.begin(), m_matches.end(),
+                                       [&](uint64_t i) { return !matches_query(logger.message(i)); }),
+                        m_matches.end());
+    }
+    else {
+        rebuild(logger);
+    }
+}
+
+void LogView::rebuild(const Logger& logger)
+{
+    m_matches.clear();
+
+    // k-way merge of the per-level lists, which are each already sorted by sequence number
+    std::array<size_t, NUM_LEVELS> cursors = {};
+
+    while (true) {
+        size_t next_level = NUM_LEVELS;
+        for (size_t level = (size_t)m_min_level; level < NUM_LEVELS; level++) {
+            if (cursors[level] < m_by_level[level].size() &&
+                (next_level == NUM_LEVELS ||
+                 m_by_level[level][cursors[level]] < m_by_level[next_level][cursors[next_level]])) {
+                next_level = level;
+            }
+        }
+
+        if (next_level == NUM_LEVELS) {
+            break;
+        }
+
+        const uint64_t i = m_by_level[next_level][cursors[next_level]++];
+        if (matches_query(logger.message(i))) {
+            m_matches.push_back(i);
+        }
+    }
+}
+
+}  // namespace lldbg
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Log.hpp"
+
+#include <array>
+#include <deque>
+#include <string>
+
+namespace lldbg {
+
+// The sequence numbers of the retained log messages that pass the Log pane's filter.
+// Messages are bucketed by level once as they arrive, so changing the level filter is a merge
+// of precomputed lists, and the substring filter only ever inspects each message once per
+// query (or only the current matches, when the query is extended while typing).
+class LogView final {
+    static constexpr size_t NUM_LEVELS = (size_t)LogLevel::Error + 1;
+
+    std::array<std::deque<uint64_t>, NUM_LEVELS> m_by_level;
+    std::array<uint64_t, NUM_LEVELS> m_total_by_level = {};
+    uint64_t m_next_message = 0;
+
+    LogLevel m_min_level = LogLevel::Verbose;
+    std::string m_query;  // lowercase
+    std::deque<uint64_t> m_matches;
+
+    bool matches_query(const LogMessage& message) const;
+    void rebuild(const Logger& logger);
+
+public:
+    // Must be called from the thread that drains the logger
+    void update(const Logger& logger);
+    void set_filter(const Logger& logger, LogLevel min_level, const std::string& query);
+
+    size_t size() const { return m_matches.size(); }
+    uint64_t operator[](size_t index) const { return m_matches[index]; }
+    uint64_t total(LogLevel level) const { return m_total_by_level[(size_t)level]; }
+};
+
+}  // namespace lldbg
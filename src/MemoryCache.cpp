@@ -0,0 +1,104 @@
+#include "MemoryCache.hpp"
+
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace lldbg {
+
+MemoryPage& MemoryCache::insert(uint64_t page_address)
+{
+    auto existing = m_index.find(page_address);
+    if (existing != m_index.end()) {
+        m_pages.splice(m_pages.begin(), m_pages, existing->second);
+        return m_pages.front();
+    }
+
+    if (m_pages.size() >= MAX_PAGES) {
+        // recycle the least recently used page, along with its buffer
+        m_index.erase(m_pages.back().address);
+        m_pages.splice(m_pages.begin(), m_pages, std::prev(m_pages.end()));
+    }
+    else {
+        m_pages.emplace_front();
+    }
+
+    MemoryPage& page = m_pages.front();
+    page.address = page_address;
+    page.readable = false;
+    m_index[page_address] = m_pages.begin();
+
+    return page;
+}
+
+void MemoryCache::read_pages(lldb::SBProcess process, uint64_t first_page, size_t count)
+{
+    PROFILE_SCOPE("MemoryCache::read_pages");
+
+    std::vector<uint8_t> block(count * PAGE_SIZE);
+    lldb::SBError error;
+    const size_t bytes_read = SB_CALL(Process, process.ReadMemory(first_page, block.data(), block.size(), error));
+
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t address = first_page + i * PAGE_SIZE;
+        MemoryPage& page = insert(address);
+        page.bytes.resize(PAGE_SIZE);
+
+        if ((i + 1) * PAGE_SIZE <= bytes_read) {
+            std::copy(block.begin() + i * PAGE_SIZE, block.begin() + (i + 1) * PAGE_SIZE, page.bytes.begin());
+            page.readable = true;
+        }
+        else {
+            // the block ran into unmapped memory, which may be mapped again further on
+            lldb::SBError page_error;
+            page.readable =
+                SB_CALL(Process, process.ReadMemory(address, page.bytes.data(), PAGE_SIZE, page_error)) == PAGE_SIZE;
+        }
+    }
+}
+
+const MemoryPage& MemoryCache::page(lldb::SBProcess process, uint64_t address, Direction direction)
+{
+    const uint64_t requested = page_address(address);
+
+    auto it = m_index.find(requested);
+    if (it != m_index.end()) {
+        m_hits++;
+        m_pages.splice(m_pages.begin(), m_pages, it->second);
+        return m_pages.front();
+    }
+
+    m_misses++;
+
+    // extend the read over uncached pages only, without wrapping around the address space
+    uint64_t first_page = requested;
+    size_t count = 1;
+    if (direction == Direction::Forward) {
+        while (count < READ_AHEAD_PAGES && requested + count * PAGE_SIZE != 0 &&
+               m_index.count(requested + count * PAGE_SIZE) == 0) {
+            count++;
+        }
+    }
+    else {
+        while (count < READ_AHEAD_PAGES && first_page != 0 && m_index.count(first_page - PAGE_SIZE) == 0) {
+            first_page -= PAGE_SIZE;
+            count++;
+        }
+    }
+
+    read_pages(process, first_page, count);
+
+    it = m_index.find(requested);
+    m_pages.splice(m_pages.begin(), m_pages, it->second);
+    return m_pages.front();
+}
+
+void MemoryCache::invalidate()
+{
+    m_pages.clear();
+    m_index.clear();
+}
+
+}  // namespace lldbg
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace lldbg {
+
+struct MemoryPage {
+    uint64_t address = 0;
+    bool readable = false;
+    std::vector<uint8_t> bytes;  // PAGE_SIZE bytes when readable
+};
+
+// Inferior memory read in page-sized blocks and kept in a small LRU cache. Every ReadMemory call
+// is a round trip to the debug server, so a miss also reads the next READ_AHEAD_PAGES - 1 pages
+// in the direction the view is moving. Must be invalidated whenever the process resumes.
+class MemoryCache final {
+public:
+    static constexpr uint64_t PAGE_SIZE = 4096;
+    static constexpr size_t MAX_PAGES = 512;
+    static constexpr size_t READ_AHEAD_PAGES = 8;
+
+    enum class Direction { Forward, Backward };
+
+private:
+    std::list<MemoryPage> m_pages;  // most recently used first
+    std::unordered_map<uint64_t, std::list<MemoryPage>::iterator> m_index;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+
+    void read_pages(lldb::SBProcess process, uint64_t first_page, size_t count);
+    MemoryPage& insert(uint64_t page_address);
+
+public:
+    static uint64_t page_address(uint64_t address) { return address & ~(PAGE_SIZE - 1); }
+
+    const MemoryPage& page(lldb::SBProcess process, uint64_t address, Direction direction = Direction::Forward);
+    void invalidate();
+
+    size_t size() const { return m_pages.size(); }
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+};
+
+}  // namespace lldbg
@@ -0,0 +1,256 @@
+#include "ProcessList.hpp"
+
+#include "Log.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::chrono::milliseconds REFRESH_INTERVAL(1000);
+
+std::vector<int32_t> list_pids(int proc_fd, size_t buffer_size)
+{
+    std::vector<int32_t> pids;
+    std::vector<char> buffer(buffer_size);
+
+    while (true) {
+        const long bytes = syscall(SYS_getdents64, proc_fd, buffer.data(), buffer.size());
+        if (bytes <= 0) {
+            break;
+        }
+
+        for (long offset = 0; offset < bytes;) {
+            // glibc's dirent64 has the layout getdents64 fills the buffer with
+            const dirent64* entry = (const dirent64*)(buffer.data() + offset);
+            offset += entry->d_reclen;
+
+            if (entry->d_type != DT_DIR || !isdigit((unsigned char)entry->d_name[0])) {
+                continue;
+            }
+            pids.push_back((int32_t)atoi(entry->d_name));
+        }
+    }
+
+    std::sort(pids.begin(), pids.end());
+    return pids;
+}
+
+// reads a small /proc file in one go, returns the number of bytes read or -1
+ssize_t read_proc_file(int proc_fd, const char* path, char* buffer, size_t size)
+{
+    const int fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    const ssize_t bytes = read(fd, buffer, size);
+    close(fd);
+    return bytes;
+}
+
+// Reads the name, parent and start time, false when the process exited
+bool read_stat(int proc_fd, int32_t pid, lldbg::ProcessInfo& info)
+{
+    char path[64];
+    char buffer[1024];
+
+    info.pid = pid;
+
+    // "pid (comm) state ppid ...", where comm may itself contain spaces and parentheses
+    snprintf(path, sizeof(path), "%d/stat", pid);
+    const ssize_t stat_bytes = read_proc_file(proc_fd, path, buffer, sizeof(buffer) - 1);
+    if (stat_bytes <= 0) {
+        return false;
+    }
+    buffer[stat_bytes] = '\0';
+
+    const char* comm_begin = strchr(buffer, '(');
+    const char* comm_end = strrchr(buffer, ')');
+    if (!comm_begin || !comm_end || comm_end < comm_begin) {
+        return false;
+    }
+    info.name.assign(comm_begin + 1, comm_end);
+
+    // starttime is field 22, the 20th after comm
+    char state = 0;
+    int ppid = 0;
+    unsigned long long start_time = 0;
+    const int fields = sscanf(comm_end + 1,
+                              " %c %d %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %*s %llu",
+                              &state, &ppid, &start_time);
+    if (fields >= 2) {
+        info.ppid = ppid;
+    }
+    info.start_time = fields == 3 ? start_time : 0;
+
+    return true;
+}
+
+// false when the process exited while being read
+bool read_process(int proc_fd, int32_t pid, lldbg::ProcessInfo& info)
+{
+    char path[64];
+    char buffer[4096];
+
+    snprintf(path, sizeof(path), "%d", pid);
+    struct stat dir_stat;
+    if (fstatat(proc_fd, path, &dir_stat, 0) != 0) {
+        return false;
+    }
+    info.uid = dir_stat.st_uid;
+
+    if (!read_stat(proc_fd, pid, info)) {
+        return false;
+    }
+
+    // only the start of very long command lines is kept
+    snprintf(path, sizeof(path), "%d/cmdline", pid);
+    const ssize_t cmdline_bytes = read_proc_file(proc_fd, path, buffer, sizeof(buffer));
+    info.command_line.clear();
+    if (cmdline_bytes > 0) {
+        info.command_line.assign(buffer, cmdline_bytes);
+        while (!info.command_line.empty() && info.command_line.back() == '\0') {
+            info.command_line.pop_back();
+        }
+        std::replace(info.command_line.begin(), info.command_line.end(), '\0', ' ');
+    }
+
+    return true;
+}
+
+bool contains_ignoring_case(const std::string& haystack, const std::string& lowercase_needle)
+{
+    auto it = std::search(haystack.begin(), haystack.end(), lowercase_needle.begin(), lowercase_needle.end(),
+                          [](char a, char b) { return tolower((unsigned char)a) == b; });
+    return it != haystack.end();
+}
+
+}  // namespace
+
+namespace lldbg {
+
+std::optional<ProcessList::Scan> ProcessList::scan(const std::vector<ProcessInfo>& known_processes)
+{
+    const int proc_fd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0) {
+        LOG(Error) << "Failed to open /proc: " << strerror(errno);
+        return {};
+    }
+
+    const std::vector<int32_t> pids = list_pids(proc_fd, GETDENTS_BUFFER_SIZE);
+
+    // both are sorted by pid, so known processes are carried over in one merge pass
+    Scan result;
+    result.processes.reserve(pids.size());
+
+    auto known = known_processes.begin();
+    for (int32_t pid : pids) {
+        while (known != known_processes.end() && known->pid < pid) {
+            ++known;
+            result.changed = true;  // exited
+        }
+
+        // a pid that was reused or a process that exec'd has another start time or name, in which
+        // case the rest is read again as for a new process
+        ProcessInfo info;
+        if (known != known_processes.end() && known->pid == pid) {
+            const ProcessInfo& known_info = *known;
+            ++known;
+            if (!read_stat(proc_fd, pid, info)) {
+                result.changed = true;  // exited
+                continue;
+            }
+            if (info.start_time == known_info.start_time && info.name == known_info.name) {
+                result.processes.push_back(known_info);
+                result.processes.back().ppid = info.ppid;
+                continue;
+            }
+        }
+
+        if (read_process(proc_fd, pid, info)) {
+            result.processes.push_back(std::move(info));
+            result.changed = true;
+        }
+    }
+    result.changed = result.changed || known != known_processes.end();
+
+    close(proc_fd);
+
+    return result;
+}
+
+void ProcessList::apply(std::optional<Scan> result)
+{
+    if (!result) {
+        return;
+    }
+
+    m_processes = std::move(result->processes);
+    if (result->changed) {
+        m_version++;
+    }
+}
+
+void ProcessList::refresh()
+{
+    PROFILE_SCOPE("ProcessList::refresh");
+
+    if (m_pending.valid()) {
+        apply(m_pending.get());
+    }
+
+    m_last_refresh = std::chrono::steady_clock::now();
+    apply(scan(m_processes));
+}
+
+void ProcessList::refresh_if_stale()
+{
+    if (m_pending.valid()) {
+        if (m_pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            apply(m_pending.get());
+        }
+        return;
+    }
+
+    if (std::chrono::steady_clock::now() - m_last_refresh >= REFRESH_INTERVAL) {
+        // m_processes is only read by the scan, and only replaced once it is done
+        m_last_refresh = std::chrono::steady_clock::now();
+        m_pending = std::async(std::launch::async, [this]() { return scan(m_processes); });
+    }
+}
+
+const std::vector<size_t>& ProcessList::filter(const std::string& query)
+{
+    std::string lowercase_query = query;
+    std::transform(lowercase_query.begin(), lowercase_query.end(), lowercase_query.begin(),
+                   [](char c) { return (char)tolower((unsigned char)c); });
+
+    if (m_filter_version == m_version && m_filter_query == lowercase_query) {
+        return m_filtered;
+    }
+
+    m_filter_query = lowercase_query;
+    m_filter_version = m_version;
+    m_filtered.clear();
+
+    for (size_t i = 0; i < m_processes.size(); i++) {
+        const ProcessInfo& process = m_processes[i];
+        if (lowercase_query.empty() || contains_ignoring_case(process.name, lowercase_query) ||
+            contains_ignoring_case(process.command_line, lowercase_query) ||
+            contains_ignoring_case(std::to_string(process.pid), lowercase_query)) {
+            m_filtered.push_back(i);
+        }
+    }
+
+    return m_filtered;
+}
+
+}  // namespace lldbg
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lldbg {
+
+struct ProcessInfo {
+    int32_t pid = 0;
+    int32_t ppid = 0;
+    uint32_t uid = 0;
+    uint64_t start_time = 0;   // in clock ticks since boot, tells a reused pid apart
+    std::string name;          // the comm field of /proc/PID/stat, at most 15 characters
+    std::string command_line;  // /proc/PID/cmdline with the NULs replaced by spaces, empty for kernel threads
+};
+
+// The processes running on this machine, for picking one to attach to. A rescan lists the /proc
+// directory in large getdents64 batches and reads each process's stat, but only reads cmdline for
+// pids that were not there the previous time or whose start time or name changed (pid reuse or
+// exec). That is still a few syscalls per process, so the periodic rescan runs on a background
+// thread and its result is swapped in by a later call. Processes that exit are dropped on the next
+// refresh.
+class ProcessList final {
+    static constexpr size_t GETDENTS_BUFFER_SIZE = 64 * 1024;
+
+    struct Scan {
+        std::vector<ProcessInfo> processes;  // sorted by pid
+        bool changed = false;                // whether processes started or exited
+    };
+
+    std::vector<ProcessInfo> m_processes;  // sorted by pid
+    std::chrono::steady_clock::time_point m_last_refresh;
+    uint64_t m_version = 0;
+
+    // cached result of filter(), valid while the query and version match
+    std::string m_filter_query;
+    uint64_t m_filter_version = 0;
+    std::vector<size_t> m_filtered;
+
+    // declared last, so that a scan underway is waited for before m_processes is destroyed
+    std::future<std::optional<Scan>> m_pending;
+
+    static std::optional<Scan> scan(const std::vector<ProcessInfo>& known_processes);
+    void apply(std::optional<Scan> result);
+
+public:
+    ProcessList() = default;
+
+    // a scan underway reads m_processes
+    ProcessList(const ProcessList&) = delete;
+    ProcessList& operator=(const ProcessList&) = delete;
+
+    // rescans on the calling thread, after waiting for any scan underway
+    void refresh();
+
+    // starts a rescan in the background when the last one was more than a second ago, and swaps
+    // in its result once it is done
+    void refresh_if_stale();
+
+    // indices into processes() of those whose pid, name or command line contains the query,
+    // ignoring case
+    const std::vector<size_t>& filter(const std::string& query);
+
+    const std::vector<ProcessInfo>& processes() const { return m_processes; }
+
+    // incremented on every refresh that found processes starting or exiting
+    uint64_t version() const { return m_version; }
+};
+
+}  // namespace lldbg
@@ -0,0 +1,123 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+thread_local bool t_is_render_thread = false;
+
+double percentile_us(std::vector<uint64_t>& sorted_ns, double p)
+{
+    const size_t index = std::min(sorted_ns.size() - 1, (size_t)(p * (double)sorted_ns.size()));
+    return (double)sorted_ns[index] / 1000.0;
+}
+
+}  // namespace
+
+namespace lldbg {
+
+Profiler g_profiler;
+
+void Profiler::begin_frame()
+{
+    t_is_render_thread = true;
+
+    if (m_paused) {
+        m_frame_timer.reset();
+        return;
+    }
+
+    current_frame().samples.clear();
+    m_depth = 0;
+    m_frame_timer.emplace();
+}
+
+void Profiler::end_frame()
+{
+    if (!m_frame_timer) {
+        return;
+    }
+
+    current_frame().duration_ns = m_frame_timer->elapsed_ns();
+    m_frame_timer.reset();
+    m_frame_count++;
+}
+
+size_t Profiler::begin_sample(const char* name)
+{
+    std::vector<ProfileSample>& samples = current_frame().samples;
+    samples.push_back({name, m_depth++, m_frame_timer->elapsed_ns(), 0});
+    return samples.size() - 1;
+}
+
+void Profiler::end_sample(size_t index)
+{
+    ProfileSample& sample = current_frame().samples[index];
+    sample.duration_ns = m_frame_timer->elapsed_ns() - sample.start_ns;
+    m_depth--;
+}
+
+std::vector<ProfileSectionStats> Profiler::section_stats() const
+{
+    struct Section {
+        uint32_t depth;
+        size_t calls = 0;
+        std::vector<uint64_t> per_frame_ns;
+    };
+
+    // sections are identified by their (literal) name, ordered by first appearance in the frame
+    std::vector<std::pair<const char*, Section>> sections;
+    auto find_section = [&](const char* name) -> Section* {
+        for (auto& section : sections) {
+            if (section.first == name || strcmp(section.first, name) == 0) {
+                return &section.second;
+            }
+        }
+        return nullptr;
+    };
+
+    const size_t num_frames = completed_frames();
+
+    for (size_t f = 0; f < num_frames; f++) {
+        const ProfileFrame& frame = completed_frame(f);
+
+        for (const ProfileSample& sample : frame.samples) {
+            Section* section = find_section(sample.name);
+            if (!section) {
+                sections.push_back({sample.name, Section{sample.depth, 0, std::vector<uint64_t>(num_frames, 0)}});
+                section = &sections.back().second;
+            }
+            section->per_frame_ns[f] += sample.duration_ns;
+            section->calls++;
+        }
+    }
+
+    std::vector<ProfileSectionStats> stats;
+    for (auto& entry : sections) {
+        std::vector<uint64_t>& durations = entry.second.per_frame_ns;
+        std::sort(durations.begin(), durations.end());
+
+        stats.push_back({entry.first, entry.second.depth, percentile_us(durations, 0.5),
+                         percentile_us(durations, 0.99), (double)durations.back() / 1000.0,
+                         (double)entry.second.calls / (double)num_frames});
+    }
+
+    return stats;
+}
+
+ProfileScope::ProfileScope(const char* name)
+{
+    if (t_is_render_thread && g_profiler.recording()) {
+        m_index = g_profiler.begin_sample(name);
+    }
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (m_index) {
+        g_profiler.end_sample(*m_index);
+    }
+}
+
+}  // namespace lldbg
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Defer.hpp"
+#include "Timer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Times the enclosing scope as a section of the current frame. Only the render thread records,
+// scopes entered on any other thread cost a thread_local check and nothing else.
+#define PROFILE_SCOPE(NAME) lldbg::ProfileScope TOKEN_PASTE(profile_scope_, __COUNTER__)(NAME)
+
+namespace lldbg {
+
+struct ProfileSample {
+    const char* name;  // must be a string literal
+    uint32_t depth;
+    uint64_t start_ns;  // relative to the start of the frame
+    uint64_t duration_ns;
+};
+
+struct ProfileFrame {
+    uint64_t duration_ns = 0;
+    std::vector<ProfileSample> samples;
+};
+
+struct ProfileSectionStats {
+    const char* name;
+    uint32_t depth;
+    double p50_us;
+    double p99_us;
+    double max_us;
+    double calls_per_frame;
+};
+
+// Records a hierarchy of timed sections for each of the most recent frames into a ring,
+// from which rolling percentiles per section are computed for the profiler overlay.
+class Profiler final {
+    static constexpr size_t NUM_FRAMES = 240;
+
+    std::array<ProfileFrame, NUM_FRAMES> m_frames;
+    uint64_t m_frame_count = 0;
+    std::optional<Timer> m_frame_timer;
+    uint32_t m_depth = 0;
+    bool m_paused = false;
+
+    ProfileFrame& current_frame() { return m_frames[m_frame_count % NUM_FRAMES]; }
+
+public:
+    void begin_frame();
+    void end_frame();
+
+    // returns the index of the new sample in the current frame
+    size_t begin_sample(const char* name);
+    void end_sample(size_t index);
+    bool recording() const { return m_frame_timer.has_value(); }
+
+    void set_paused(bool paused) { m_paused = paused; }
+    bool paused() const { return m_paused; }
+
+    // 0 is the most recently completed frame
+    size_t completed_frames() const { return m_frame_count < NUM_FRAMES ? m_frame_count : NUM_FRAMES - 1; }
+    const ProfileFrame& completed_frame(size_t frames_ago) const
+    {
+        return m_frames[(m_frame_count - 1 - frames_ago) % NUM_FRAMES];
+    }
+
+    std::vector<ProfileSectionStats> section_stats() const;
+};
+
+extern Profiler g_profiler;
+
+class ProfileScope final {
+    std::optional<size_t> m_index;
+
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+}  // namespace lldbg
@@ -0,0 +1,258 @@
+#include "Registers.hpp"
+
+#include "Prelude.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+template <typename T>
+T read_lane(const std::vector<uint8_t>& bytes, size_t offset)
+{
+    T lane;
+    memcpy(&lane, bytes.data() + offset, sizeof(T));
+    return lane;
+}
+
+size_t lane_size(lldbg::LaneFormat format)
+{
+    switch (format) {
+        case lldbg::LaneFormat::Hex8:
+            return 1;
+        case lldbg::LaneFormat::Hex16:
+            return 2;
+        case lldbg::LaneFormat::Hex32:
+        case lldbg::LaneFormat::Int32:
+        case lldbg::LaneFormat::Float32:
+            return 4;
+        case lldbg::LaneFormat::Hex64:
+        case lldbg::LaneFormat::Float64:
+        case lldbg::LaneFormat::COUNT:
+            break;
+    }
+    return 8;
+}
+
+void format_lane(const std::vector<uint8_t>& bytes, size_t offset, lldbg::LaneFormat format, char* out, size_t size)
+{
+    switch (format) {
+        case lldbg::LaneFormat::Hex8:
+            snprintf(out, size, "0x%02" PRIx8, read_lane<uint8_t>(bytes, offset));
+            break;
+        case lldbg::LaneFormat::Hex16:
+            snprintf(out, size, "0x%04" PRIx16, read_lane<uint16_t>(bytes, offset));
+            break;
+        case lldbg::LaneFormat::Hex32:
+            snprintf(out, size, "0x%08" PRIx32, read_lane<uint32_t>(bytes, offset));
+            break;
+        case lldbg::LaneFormat::Int32:
+            snprintf(out, size, "%" PRId32, read_lane<int32_t>(bytes, offset));
+            break;
+        case lldbg::LaneFormat::Float32:
+            snprintf(out, size, "%g", (double)read_lane<float>(bytes, offset));
+            break;
+        case lldbg::LaneFormat::Float64:
+            snprintf(out, size, "%g", read_lane<double>(bytes, offset));
+            break;
+        case lldbg::LaneFormat::Hex64:
+        case lldbg::LaneFormat::COUNT:
+            snprintf(out, size, "0x%016" PRIx64, read_lane<uint64_t>(bytes, offset));
+            break;
+    }
+}
+
+// Registers keep their order between stops, so matching by index almost always succeeds and the
+// name lookup is only built when the layout differs.
+void mark_changes(lldbg::RegisterSnapshot& current, const lldbg::RegisterSnapshot& previous)
+{
+    std::unordered_map<std::string, size_t> previous_by_name;
+
+    current.num_changed = 0;
+    for (size_t i = 0; i < current.registers.size(); i++) {
+        lldbg::RegisterValue& value = current.registers[i];
+
+        const lldbg::RegisterValue* old_value = nullptr;
+        if (i < previous.registers.size() && previous.registers[i].name == value.name) {
+            old_value = &previous.registers[i];
+        }
+        else {
+            if (previous_by_name.empty()) {
+                for (size_t j = 0; j < previous.registers.size(); j++) {
+                    previous_by_name.emplace(previous.registers[j].name, j);
+                }
+            }
+            auto it = previous_by_name.find(value.name);
+            if (it != previous_by_name.end()) {
+                old_value = &previous.registers[it->second];
+            }
+        }
+
+        value.changed = old_value != nullptr && old_value->bytes != value.bytes;
+        if (value.changed) {
+            current.num_changed++;
+        }
+    }
+}
+
+}  // namespace
+
+namespace lldbg {
+
+const char* lane_format_name(LaneFormat format)
+{
+    switch (format) {
+        case LaneFormat::Hex8:
+            return "hex u8";
+        case LaneFormat::Hex16:
+            return "hex u16";
+        case LaneFormat::Hex32:
+            return "hex u32";
+        case LaneFormat::Hex64:
+            return "hex u64";
+        case LaneFormat::Int32:
+            return "i32";
+        case LaneFormat::Float32:
+            return "f32";
+        case LaneFormat::Float64:
+            return "f64";
+        case LaneFormat::COUNT:
+            break;
+    }
+    return "unknown";
+}
+
+std::string format_lanes(const std::vector<uint8_t>& bytes, LaneFormat format)
+{
+    const size_t size = lane_size(format);
+
+    std::string formatted = "{";
+    char lane[32];
+    for (size_t offset = 0; offset + size <= bytes.size(); offset += size) {
+        format_lane(bytes, offset, format, lane, sizeof(lane));
+        if (offset > 0) {
+            formatted += ' ';
+        }
+        formatted += lane;
+    }
+    formatted += '}';
+
+    return formatted;
+}
+
+RegisterSnapshot RegisterSnapshot::build(lldb::SBFrame frame)
+{
+    PROFILE_SCOPE("RegisterSnapshot::build");
+
+    RegisterSnapshot snapshot;
+
+    lldb::SBValueList register_sets = SB_CALL(Registers, frame.GetRegisters());
+    const uint32_t num_sets = SB_CALL(Registers, register_sets.GetSize());
+
+    for (uint32_t i = 0; i < num_sets; i++) {
+        lldb::SBValue register_set = SB_CALL(Registers, register_sets.GetValueAtIndex(i));
+
+        RegisterSetRange range;
+        range.name = build_string(SB_CALL(Registers, register_set.GetName()));
+        range.begin = snapshot.registers.size();
+
+        const uint32_t num_registers = SB_CALL(Registers, register_set.GetNumChildren());
+        for (uint32_t j = 0; j < num_registers; j++) {
+            lldb::SBValue child = SB_CALL(Registers, register_set.GetChildAtIndex(j));
+
+            RegisterValue value;
+            value.name = build_string(SB_CALL(Registers, child.GetName()));
+            value.value = build_string(SB_CALL(Registers, child.GetValue()));
+            value.is_vector = SB_CALL(Registers, child.GetType().IsVectorType());
+
+            lldb::SBData data = SB_CALL(Registers, child.GetData());
+            value.bytes.resize(data.GetByteSize());
+            if (!value.bytes.empty()) {
+                lldb::SBError error;
+                data.ReadRawData(error, 0, value.bytes.data(), value.bytes.size());
+                if (error.Fail()) {
+                    value.bytes.clear();
+                }
+            }
+
+            snapshot.registers.push_back(std::move(value));
+        }
+
+        range.end = snapshot.registers.size();
+        snapshot.sets.push_back(std::move(range));
+    }
+
+    return snapshot;
+}
+
+void RegisterCache::forget_exited_threads(const StopSnapshot& snapshot)
+{
+    std::unordered_set<uint64_t> live_threads;
+    for (const ThreadSnapshot& thread : snapshot.threads) {
+        live_threads.insert(thread.thread_id);
+    }
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (live_threads.count(it->first.first) == 0) {
+            it = m_entries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+const RegisterSnapshot& RegisterCache::get(lldb::SBProcess process, const StopSnapshot& snapshot,
+                                           size_t thread_index, uint32_t frame_index)
+{
+    if (snapshot.stop_id != m_last_stop_id) {
+        forget_exited_threads(snapshot);
+        m_previous_stop_id = m_last_stop_id;
+        m_last_stop_id = snapshot.stop_id;
+    }
+
+    const uint64_t thread_id = snapshot.threads[thread_index].thread_id;
+
+    auto it = m_entries.find({thread_id, frame_index});
+    if (it != m_entries.end() && it->second.stop_id == snapshot.stop_id) {
+        return it->second;
+    }
+
+    lldb::SBThread thread = SB_CALL(Process, process.GetThreadByID(thread_id));
+    RegisterSnapshot registers = RegisterSnapshot::build(SB_CALL(Thread, thread.GetFrameAtIndex(frame_index)));
+    registers.stop_id = snapshot.stop_id;
+    registers.thread_id = thread_id;
+    registers.frame_index = frame_index;
+
+    if (it == m_entries.end()) {
+        it = m_entries.emplace(std::make_pair(thread_id, frame_index), RegisterSnapshot()).first;
+    }
+    else {
+        mark_changes(registers, it->second);
+        registers.compared_stop_id = it->second.stop_id;
+    }
+    it->second = std::move(registers);
+
+    return it->second;
+}
+
+void RegisterCache::capture(lldb::SBProcess process, const StopSnapshot& snapshot)
+{
+    if (snapshot.selected_thread < snapshot.threads.size()) {
+        get(process, snapshot, snapshot.selected_thread, 0);
+    }
+}
+
+void RegisterCache::clear()
+{
+    m_entries.clear();
+    m_last_stop_id = 0;
+    m_previous_stop_id = 0;
+}
+
+}  // namespace lldbg
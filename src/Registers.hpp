@@ -0,0 +1,72 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include "StopSnapshot.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lldbg {
+
+// How the lanes of a vector register (SSE/AVX/NEON) are displayed
+enum class LaneFormat { Hex8, Hex16, Hex32, Hex64, Int32, Float32, Float64, COUNT };
+
+const char* lane_format_name(LaneFormat format);
+
+// "{lane0 lane1 ...}", lowest lane first. The bytes are assumed to be in host byte order.
+std::string format_lanes(const std::vector<uint8_t>& bytes, LaneFormat format);
+
+struct RegisterValue {
+    std::string name;
+    std::string value;           // as formatted by LLDB
+    std::vector<uint8_t> bytes;  // raw contents
+    bool is_vector = false;
+    bool changed = false;
+};
+
+struct RegisterSetRange {
+    std::string name;
+    size_t begin = 0;  // into RegisterSnapshot::registers
+    size_t end = 0;
+};
+
+// The registers of one frame at one stop, flattened across register sets
+struct RegisterSnapshot {
+    uint32_t stop_id = 0;
+    uint64_t thread_id = 0;
+    uint32_t frame_index = 0;
+    uint32_t compared_stop_id = 0;  // of the earlier read 'changed' is relative to, 0 when there was none
+    std::vector<RegisterValue> registers;
+    std::vector<RegisterSetRange> sets;
+    size_t num_changed = 0;
+
+    static RegisterSnapshot build(lldb::SBFrame frame);
+};
+
+// Each register set is a tree of SBValues that is slow to walk, so the registers of a frame are
+// read at most once per stop. 'changed' is relative to the last stop at which the same thread and
+// frame were read, which capture makes the previous stop for the innermost frame of the thread
+// selected at each stop.
+class RegisterCache final {
+    std::map<std::pair<uint64_t, uint32_t>, RegisterSnapshot> m_entries;  // by (thread id, frame index)
+    uint32_t m_last_stop_id = 0;
+    uint32_t m_previous_stop_id = 0;
+
+    void forget_exited_threads(const StopSnapshot& snapshot);
+
+public:
+    const RegisterSnapshot& get(lldb::SBProcess process, const StopSnapshot& snapshot, size_t thread_index,
+                                uint32_t frame_index);
+    // reads the innermost frame of the selected thread, to be called at every stop
+    void capture(lldb::SBProcess process, const StopSnapshot& snapshot);
+    void clear();
+
+    // the stop before the one last read, as far as the cache saw
+    uint32_t previous_stop_id() const { return m_previous_stop_id; }
+};
+
+}  // namespace lldbg
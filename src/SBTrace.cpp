@@ -0,0 +1,279 @@
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+uint32_t this_thread_trace_id()
+{
+    static std::atomic<uint32_t> s_next_id = {1};
+    thread_local uint32_t t_id = s_next_id.fetch_add(1);
+    return t_id;
+}
+
+void write_json_string(std::ostream& out, const char* str)
+{
+    out << '"';
+    for (const char* c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        }
+        else if ((unsigned char)*c < 0x20) {
+            out << ' ';
+        }
+        else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+}  // namespace
+
+namespace lldbg {
+
+SBTrace g_sb_trace;
+
+const char* sb_call_category_name(SBCallCategory category)
+{
+    switch (category) {
+        case SBCallCategory::Process:
+            return "Process";
+        case SBCallCategory::Thread:
+            return "Thread";
+        case SBCallCategory::Frame:
+            return "Frame";
+        case SBCallCategory::Variables:
+            return "Variables";
+        case SBCallCategory::Registers:
+            return "Registers";
+        case SBCallCategory::LineEntry:
+            return "LineEntry";
+        case SBCallCategory::Breakpoint:
+            return "Breakpoint";
+        case SBCallCategory::Watchpoint:
+            return "Watchpoint";
+        case SBCallCategory::Disassembly:
+            return "Disassembly";
+        case SBCallCategory::Command:
+            return "Command";
+        case SBCallCategory::Target:
+            return "Target";
+        case SBCallCategory::Symbols:
+            return "Symbols";
+        case SBCallCategory::COUNT:
+            break;
+    }
+    return "Unknown";
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t ns)
+{
+    if (ns < SUB_BUCKETS) {
+        return (size_t)ns;
+    }
+
+    const uint32_t msb = 63 - (uint32_t)__builtin_clzll(ns);
+    const uint32_t shift = msb - SUB_BUCKET_BITS;
+    const uint64_t sub_bucket = (ns >> shift) - SUB_BUCKETS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index)
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+
+    const uint64_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    const uint64_t sub_bucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + sub_bucket) << shift) + ((uint64_t)1 << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t ns)
+{
+    m_counts[bucket_index(ns)]++;
+    m_total++;
+    m_max_ns = std::max(m_max_ns, ns);
+}
+
+uint64_t LatencyHistogram::percentile_ns(double p) const
+{
+    if (m_total == 0) {
+        return 0;
+    }
+
+    const uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(p * (double)m_total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        seen += m_counts[i];
+        if (seen >= target) {
+            return std::min(bucket_upper_bound(i), m_max_ns);
+        }
+    }
+
+    return m_max_ns;
+}
+
+void LatencyHistogram::write_percentile_distribution(std::ostream& out) const
+{
+    out << std::fixed;
+    out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+
+    uint64_t seen = 0;
+    double sum_us = 0.0;
+    for (size_t i = 0; i < m_counts.size(); i++) {
+        if (m_counts[i] == 0) {
+            continue;
+        }
+
+        seen += m_counts[i];
+        const double value_us = (double)std::min(bucket_upper_bound(i), m_max_ns) / 1000.0;
+        const double percentile = (double)seen / (double)m_total;
+        sum_us += value_us * (double)m_counts[i];
+
+        out << std::setw(12) << std::setprecision(3) << value_us << ' ' << std::setw(14) << std::setprecision(12)
+            << percentile << ' ' << std::setw(10) << seen << ' ';
+        if (seen < m_total) {
+            out << std::setw(14) << std::setprecision(2) << 1.0 / (1.0 - percentile) << '\n';
+        }
+        else {
+            out << std::setw(14) << "inf" << '\n';
+        }
+    }
+
+    const double mean_us = m_total > 0 ? sum_us / (double)m_total : 0.0;
+    out << std::setprecision(3);
+    out << "#[Mean    = " << std::setw(12) << mean_us << ", Total count    = " << std::setw(12) << m_total << "]\n";
+    out << "#[Max     = " << std::setw(12) << (double)m_max_ns / 1000.0
+        << ", SubBuckets     = " << std::setw(12) << SUB_BUCKETS << "]\n";
+}
+
+uint64_t SBTrace::now_ns()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void SBTrace::set_enabled(bool enabled)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (enabled && !m_enabled.load(std::memory_order_relaxed)) {
+        m_start_ns = now_ns();
+        m_current_frame = {};
+        m_last_frame = {};
+        for (LatencyHistogram& histogram : m_histograms) {
+            histogram.reset();
+        }
+        m_events.clear();
+        m_dropped_events = 0;
+    }
+
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SBTrace::record(SBCallCategory category, const char* name, uint64_t start_ns, uint64_t duration_ns)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    SBCallCounts& counts = m_current_frame[(size_t)category];
+    counts.calls++;
+    counts.total_ns += duration_ns;
+
+    m_histograms[(size_t)category].record(duration_ns);
+
+    if (m_events.size() < MAX_TRACE_EVENTS) {
+        // calls already in flight when tracing was enabled are clamped to the start of the trace
+        const uint64_t relative_start_ns = start_ns > m_start_ns ? start_ns - m_start_ns : 0;
+        m_events.push_back({name, category, this_thread_trace_id(), relative_start_ns, duration_ns});
+    }
+    else {
+        m_dropped_events++;
+    }
+}
+
+void SBTrace::end_frame()
+{
+    if (!enabled()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_last_frame = m_current_frame;
+    m_current_frame = {};
+}
+
+SBCallsByCategory SBTrace::last_frame() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_last_frame;
+}
+
+LatencyHistogram SBTrace::histogram(SBCallCategory category) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_histograms[(size_t)category];
+}
+
+void SBTrace::write_histograms(std::ostream& out) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (size_t i = 0; i < m_histograms.size(); i++) {
+        if (m_histograms[i].count() == 0) {
+            continue;
+        }
+
+        out << "# " << sb_call_category_name((SBCallCategory)i) << " (microseconds)\n";
+        m_histograms[i].write_percentile_distribution(out);
+        out << '\n';
+    }
+}
+
+bool SBTrace::write_histograms(const std::filesystem::path& path) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    write_histograms(out);
+    return (bool)out;
+}
+
+bool SBTrace::write_chrome_trace(const std::filesystem::path& path) const
+{
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_events\":" << m_dropped_events
+        << "},\"traceEvents\":[\n";
+
+    char timing[64];
+    for (size_t i = 0; i < m_events.size(); i++) {
+        const SBTraceEvent& event = m_events[i];
+
+        out << "{\"name\":";
+        write_json_string(out, event.name);
+        snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"dur\":%.3f", (double)event.start_ns / 1000.0,
+                 (double)event.duration_ns / 1000.0);
+        out << ",\"cat\":\"" << sb_call_category_name(event.category) << "\",\"ph\":\"X\"," << timing
+            << ",\"pid\":1,\"tid\":" << event.thread_id << (i + 1 < m_events.size() ? "},\n" : "}\n");
+    }
+
+    out << "]}\n";
+    return (bool)out;
+}
+
+}  // namespace lldbg
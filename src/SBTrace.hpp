@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Times an lldb::SB* call (or a short chain of them) and attributes it to a category. When
+// tracing is disabled the expression is evaluated directly after a single relaxed atomic load.
+//   lldb::SBThread thread = SB_CALL(Thread, process.GetThreadAtIndex(i));
+#define SB_CALL(CATEGORY, ...) \
+    lldbg::traced_sb_call(lldbg::SBCallCategory::CATEGORY, #__VA_ARGS__, [&]() { return __VA_ARGS__; })
+
+namespace lldbg {
+
+enum class SBCallCategory {
+    Process,
+    Thread,
+    Frame,
+    Variables,
+    Registers,
+    LineEntry,
+    Breakpoint,
+    Watchpoint,
+    Disassembly,
+    Command,
+    Target,
+    Symbols,
+    COUNT
+};
+
+const char* sb_call_category_name(SBCallCategory category);
+
+// A log-linear latency histogram in the style of HdrHistogram: every power of two range of
+// nanoseconds is split into SUB_BUCKETS linear buckets, so values are recorded in O(1) with a
+// relative error of at most 1/SUB_BUCKETS, regardless of magnitude.
+class LatencyHistogram final {
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;
+    static constexpr uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr uint32_t MAGNITUDES = 64 - SUB_BUCKET_BITS + 1;
+
+    std::array<uint64_t, MAGNITUDES * SUB_BUCKETS> m_counts = {};
+    uint64_t m_total = 0;
+    uint64_t m_max_ns = 0;
+
+    static size_t bucket_index(uint64_t ns);
+    static uint64_t bucket_upper_bound(size_t index);
+
+public:
+    void record(uint64_t ns);
+    void reset() { *this = LatencyHistogram(); }
+
+    uint64_t count() const { return m_total; }
+    uint64_t max_ns() const { return m_max_ns; }
+    uint64_t percentile_ns(double p) const;
+
+    // The same text layout as HdrHistogram's percentile distribution output, in microseconds
+    void write_percentile_distribution(std::ostream& out) const;
+};
+
+struct SBCallCounts {
+    uint64_t calls = 0;
+    uint64_t total_ns = 0;
+};
+
+using SBCallsByCategory = std::array<SBCallCounts, (size_t)SBCallCategory::COUNT>;
+
+struct SBTraceEvent {
+    const char* name;  // the stringified call expression
+    SBCallCategory category;
+    uint32_t thread_id;
+    uint64_t start_ns;  // since tracing was enabled
+    uint64_t duration_ns;
+};
+
+// Collects every traced SB API call while enabled: per frame counts, per category latency
+// histograms and a bounded list of events that can be written out as a Chrome trace
+// (viewable in chrome://tracing or Perfetto).
+class SBTrace final {
+    static constexpr size_t MAX_TRACE_EVENTS = 1024 * 1024;
+
+    std::atomic<bool> m_enabled = {false};
+    uint64_t m_start_ns = 0;
+
+    mutable std::mutex m_mutex;
+    SBCallsByCategory m_current_frame;
+    SBCallsByCategory m_last_frame;
+    std::array<LatencyHistogram, (size_t)SBCallCategory::COUNT> m_histograms;
+    std::vector<SBTraceEvent> m_events;
+    uint64_t m_dropped_events = 0;
+
+public:
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Enabling discards everything recorded so far
+    void set_enabled(bool enabled);
+
+    void record(SBCallCategory category, const char* name, uint64_t start_ns, uint64_t duration_ns);
+    static uint64_t now_ns();
+
+    // Called once per rendered frame, makes the current per-frame counts available as last_frame()
+    void end_frame();
+    SBCallsByCategory last_frame() const;
+
+    LatencyHistogram histogram(SBCallCategory category) const;
+
+    void write_histograms(std::ostream& out) const;
+    bool write_histograms(const std::filesystem::path& path) const;
+    bool write_chrome_trace(const std::filesystem::path& path) const;
+};
+
+extern SBTrace g_sb_trace;
+
+class SBCallScope final {
+    const SBCallCategory m_category;
+    const char* m_name;
+    const uint64_t m_start_ns;
+
+public:
+    SBCallScope(SBCallCategory category, const char* name)
+        : m_category(category), m_name(name), m_start_ns(g_sb_trace.now_ns())
+    {
+    }
+    ~SBCallScope() { g_sb_trace.record(m_category, m_name, m_start_ns, g_sb_trace.now_ns() - m_start_ns); }
+
+    SBCallScope(const SBCallScope&) = delete;
+    SBCallScope& operator=(const SBCallScope&) = delete;
+};
+
+template <typename Callable>
+auto traced_sb_call(SBCallCategory category, const char* name, Callable&& f) -> decltype(f())
+{
+    if (!g_sb_trace.enabled()) {
+        return f();
+    }
+
+    SBCallScope scope(category, name);
+    return f();
+}
+
+}  // namespace lldbg
@@ -0,0 +1,122 @@
+#include "Startup.hpp"
+
+#include "Log.hpp"
+
+#include <sstream>
+
+namespace lldbg {
+
+const char* startup_milestone_name(StartupMilestone milestone)
+{
+    switch (milestone) {
+        case StartupMilestone::WindowCreated:
+            return "window created";
+        case StartupMilestone::FirstFrame:
+            return "first frame";
+        case StartupMilestone::DebuggerInitialized:
+            return "debugger initialized";
+        case StartupMilestone::TargetCreated:
+            return "target created";
+        case StartupMilestone::FirstStop:
+            return "first stop";
+        case StartupMilestone::FirstUsefulFrame:
+            return "first useful frame";
+        case StartupMilestone::COUNT:
+            break;
+    }
+    return "?";
+}
+
+StartupTimeline::StartupTimeline() : m_start(std::chrono::steady_clock::now())
+{
+    for (std::atomic<int64_t>& reached_ns : m_reached_ns) {
+        reached_ns.store(-1);
+    }
+}
+
+void StartupTimeline::reach(StartupMilestone milestone)
+{
+    const int64_t elapsed_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+
+    int64_t unreached = -1;
+    if (m_reached_ns[(size_t)milestone].compare_exchange_strong(unreached, elapsed_ns)) {
+        LOG(Info) << "Startup: " << startup_milestone_name(milestone) << " after " << (double)elapsed_ns / 1e6
+                  << " ms";
+    }
+}
+
+std::optional<double> StartupTimeline::elapsed_ms(StartupMilestone milestone) const
+{
+    const int64_t reached_ns = m_reached_ns[(size_t)milestone].load();
+    if (reached_ns < 0) {
+        return {};
+    }
+    return (double)reached_ns / 1e6;
+}
+
+void StartupTimeline::log_summary() const
+{
+    std::ostringstream summary;
+    summary << "Startup timeline:";
+    for (size_t i = 0; i < (size_t)StartupMilestone::COUNT; i++) {
+        if (const std::optional<double> ms = elapsed_ms((StartupMilestone)i)) {
+            summary << ' ' << startup_milestone_name((StartupMilestone)i) << ' ' << *ms << " ms,";
+        }
+    }
+
+    std::string text = summary.str();
+    if (text.back() == ',') {
+        text.pop_back();
+    }
+    LOG(Info) << text;
+}
+
+StartupTimeline g_startup_timeline;
+
+std::future<std::unique_ptr<Application>> start_application(StartupOptions options)
+{
+    return std::async(std::launch::async, [options = std::move(options)]() {
+        auto app = std::make_unique<Application>();
+        g_startup_timeline.reach(StartupMilestone::DebuggerInitialized);
+
+        if (options.symbol_preload_threads) {
+            app->symbol_preload_threads = *options.symbol_preload_threads;
+        }
+
+        // an attach completes later, it is noticed by the render thread
+        std::optional<TargetStartError> error;
+        if (options.attach_pid) {
+            error = attach_to_process(*app, *options.attach_pid);
+        }
+        else if (options.attach_name) {
+            error = attach_to_process(*app, *options.attach_name, options.wait_for_launch);
+        }
+        else if (options.executable && options.core_file) {
+            error = open_core_file(*app, options.executable->c_str(), options.core_file->c_str());
+        }
+        else if (options.executable) {
+            std::vector<const char*> argv;
+            for (const std::string& arg : options.args) {
+                argv.push_back(arg.c_str());
+            }
+            argv.push_back(nullptr);  // lldb::SBLaunchInfo expects a null terminated argv
+
+            error = create_new_target(*app, options.executable->c_str(), argv.data(), true, options.workdir);
+        }
+        else {
+            return app;
+        }
+
+        if (error) {
+            LOG(Error) << error->msg;
+        }
+        else if (selected_session(*app)) {
+            g_startup_timeline.reach(StartupMilestone::TargetCreated);
+        }
+
+        return app;
+    });
+}
+
+}  // namespace lldbg
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include "Application.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lldbg {
+
+// What to debug, from the command line
+struct StartupOptions {
+    std::optional<std::string> executable;
+    std::vector<std::string> args;
+    std::optional<std::string> workdir;
+    std::optional<std::string> core_file;
+    std::optional<lldb::pid_t> attach_pid;
+    std::optional<std::string> attach_name;
+    bool wait_for_launch = false;
+    std::optional<unsigned> symbol_preload_threads;
+};
+
+enum class StartupMilestone {
+    WindowCreated,
+    FirstFrame,
+    DebuggerInitialized,
+    TargetCreated,
+    FirstStop,
+    FirstUsefulFrame,  // the first frame showing the stopped target
+    COUNT
+};
+
+const char* startup_milestone_name(StartupMilestone milestone);
+
+// When each milestone of starting up was first reached, relative to process start. Milestones are
+// reached from both the render thread and the startup thread.
+class StartupTimeline final {
+    const std::chrono::steady_clock::time_point m_start;
+    std::array<std::atomic<int64_t>, (size_t)StartupMilestone::COUNT> m_reached_ns;
+
+public:
+    StartupTimeline();
+
+    // Only the first call for each milestone counts, and is logged
+    void reach(StartupMilestone milestone);
+
+    std::optional<double> elapsed_ms(StartupMilestone milestone) const;
+
+    // one line with every milestone reached so far
+    void log_summary() const;
+};
+
+extern StartupTimeline g_startup_timeline;
+
+// Initializes LLDB and creates the target on a background thread, so that the window can be
+// shown and drawn in the meantime. Target creation errors are logged, the Application is
+// returned regardless so that another target can be started from the user interface.
+std::future<std::unique_ptr<Application>> start_application(StartupOptions options);
+
+}  // namespace lldbg
@@ -0,0 +1,164 @@
+#include "StopSnapshot.hpp"
+
+#include "Prelude.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+void walk_stack(lldb::SBThread thread, lldbg::ThreadSnapshot& thread_snapshot)
+{
+    const uint32_t num_frames =
+        std::min(SB_CALL(Thread, thread.GetNumFrames()), lldbg::StopSnapshot::MAX_FRAMES_PER_THREAD);
+    thread_snapshot.frames.reserve(num_frames);
+    for (uint32_t j = 0; j < num_frames; j++) {
+        thread_snapshot.frames.push_back(lldbg::FrameSnapshot::build(SB_CALL(Frame, thread.GetFrameAtIndex(j))));
+    }
+    thread_snapshot.frames_loaded = true;
+}
+
+lldbg::StackFingerprint stack_fingerprint(lldb::SBThread thread)
+{
+    lldb::SBFrame frame = SB_CALL(Frame, thread.GetFrameAtIndex(0));
+
+    lldbg::StackFingerprint fingerprint;
+    fingerprint.pc = SB_CALL(Frame, frame.GetPC());
+    fingerprint.cfa = SB_CALL(Frame, frame.GetCFA());
+    return fingerprint;
+}
+
+}  // namespace
+
+namespace lldbg {
+
+FrameSnapshot FrameSnapshot::build(lldb::SBFrame frame)
+{
+    FrameSnapshot snapshot;
+
+    snapshot.function_name = build_string(SB_CALL(Frame, frame.GetDisplayFunctionName()));
+    snapshot.pc = SB_CALL(Frame, frame.GetPC());
+
+    lldb::SBLineEntry line_entry = SB_CALL(LineEntry, frame.GetLineEntry());
+    snapshot.file_name = build_string(SB_CALL(LineEntry, line_entry.GetFileSpec().GetFilename()));
+    snapshot.directory = build_string(SB_CALL(LineEntry, line_entry.GetFileSpec().GetDirectory()));
+    snapshot.directory.append("/");  // FIXME: not cross-platform
+    snapshot.line = (int)line_entry.GetLine();
+    snapshot.column = (int)line_entry.GetColumn();
+
+    return snapshot;
+}
+
+void StopSnapshot::load_frames(lldb::SBProcess process, size_t thread_index)
+{
+    ThreadSnapshot& thread_snapshot = threads[thread_index];
+    if (thread_snapshot.frames_loaded) {
+        return;
+    }
+
+    PROFILE_SCOPE("StopSnapshot::load_frames");
+    walk_stack(SB_CALL(Process, process.GetThreadByID(thread_snapshot.thread_id)), thread_snapshot);
+}
+
+StopSnapshot StopSnapshot::build(lldb::SBProcess process, bool frames_on_demand, StopSnapshot* previous)
+{
+    PROFILE_SCOPE("StopSnapshot::build");
+
+    StopSnapshot snapshot;
+    snapshot.stop_id = SB_CALL(Process, process.GetStopID());
+    snapshot.state = SB_CALL(Process, process.GetState());
+
+    const uint64_t selected_thread_id = SB_CALL(Process, process.GetSelectedThread().GetThreadID());
+
+    const uint32_t num_threads = SB_CALL(Process, process.GetNumThreads());
+    snapshot.threads.resize(num_threads);
+
+    std::unordered_map<uint64_t, ThreadSnapshot*> previous_threads;
+    if (previous) {
+        previous_threads.reserve(previous->threads.size());
+        for (ThreadSnapshot& thread : previous->threads) {
+            previous_threads.emplace(thread.thread_id, &thread);
+        }
+    }
+
+    for (uint32_t i = 0; i < num_threads; i++) {
+        lldb::SBThread thread = SB_CALL(Thread, process.GetThreadAtIndex(i));
+        ThreadSnapshot& thread_snapshot = snapshot.threads[i];
+
+        thread_snapshot.thread_id = thread.GetThreadID();
+        thread_snapshot.index_id = thread.GetIndexID();
+        thread_snapshot.name = build_string(SB_CALL(Thread, thread.GetName()));
+        thread_snapshot.stop_reason = SB_CALL(Thread, thread.GetStopReason());
+
+        char description[256] = {};
+        if (SB_CALL(Thread, thread.GetStopDescription(description, sizeof(description))) > 0) {
+            thread_snapshot.stop_description = description;
+        }
+
+        if (thread_snapshot.thread_id == selected_thread_id) {
+            snapshot.selected_thread = i;
+        }
+
+        thread_snapshot.fingerprint = stack_fingerprint(thread);
+
+        // A thread that stopped for a reason ran, even when it is back at the same pc and CFA: the
+        // function may have been called again from elsewhere in the same caller, so it is walked again
+        auto it = previous_threads.find(thread_snapshot.thread_id);
+        thread_snapshot.changed = it == previous_threads.end() ||
+                                  it->second->fingerprint != thread_snapshot.fingerprint ||
+                                  thread_snapshot.stop_reason != lldb::eStopReasonNone;
+        if (!thread_snapshot.changed) {
+            thread_snapshot.frames_loaded = it->second->frames_loaded;
+            thread_snapshot.frames = std::move(it->second->frames);
+            it->second->frames_loaded = false;
+        }
+        else {
+            snapshot.changed_threads++;
+        }
+
+        const bool walk = !frames_on_demand || thread_snapshot.thread_id == selected_thread_id;
+        if (walk && !thread_snapshot.frames_loaded) {
+            walk_stack(thread, thread_snapshot);
+        }
+    }
+
+    return snapshot;
+}
+
+void dump(const StopSnapshot& snapshot, std::ostream& out)
+{
+    out << "stop " << snapshot.stop_id << ": " << lldb::SBDebugger::StateAsCString(snapshot.state) << ", "
+        << snapshot.threads.size() << " threads\n";
+
+    for (size_t i = 0; i < snapshot.threads.size(); i++) {
+        const ThreadSnapshot& thread = snapshot.threads[i];
+
+        out << (i == snapshot.selected_thread ? "* " : "  ") << "thread #" << thread.index_id
+            << " tid=" << thread.thread_id;
+        if (!thread.name.empty()) {
+            out << " name=" << thread.name;
+        }
+        if (!thread.stop_description.empty()) {
+            out << " stop reason=" << thread.stop_description;
+        }
+        out << '\n';
+
+        if (!thread.frames_loaded) {
+            out << "    (stack not loaded)\n";
+        }
+
+        for (size_t j = 0; j < thread.frames.size(); j++) {
+            const FrameSnapshot& frame = thread.frames[j];
+            out << "    frame #" << j << ": 0x" << std::hex << frame.pc << std::dec << ' '
+                << (frame.function_name.empty() ? "unknown" : frame.function_name);
+            if (!frame.file_name.empty()) {
+                out << " at " << frame.file_name << ':' << frame.line;
+            }
+            out << '\n';
+        }
+    }
+}
+
+}  // namespace lldbg
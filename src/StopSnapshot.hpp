@@ -0,0 +1,68 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lldbg {
+
+struct FrameSnapshot {
+    std::string function_name;
+    std::string file_name;
+    std::string directory;  // with a trailing slash
+    int line = -1;
+    int column = -1;
+    uint64_t pc = 0;
+
+    static FrameSnapshot build(lldb::SBFrame frame);
+};
+
+// Identifies a thread's stack cheaply: if neither the innermost pc nor its canonical frame address
+// moved between two stops, the thread did not run in between and its stack is the same
+struct StackFingerprint {
+    uint64_t pc = 0;
+    uint64_t cfa = 0;
+
+    bool operator==(const StackFingerprint& other) const { return pc == other.pc && cfa == other.cfa; }
+    bool operator!=(const StackFingerprint& other) const { return !(*this == other); }
+};
+
+struct ThreadSnapshot {
+    uint64_t thread_id = 0;
+    uint32_t index_id = 0;
+    std::string name;
+    lldb::StopReason stop_reason = lldb::eStopReasonInvalid;
+    std::string stop_description;
+    StackFingerprint fingerprint;
+    bool changed = true;  // whether it ran since the previous stop: another stack, or a stop reason
+    bool frames_loaded = false;
+    std::vector<FrameSnapshot> frames;
+};
+
+// Everything displayed about a stopped process, copied out of LLDB once per stop instead of
+// being re-queried through the SB API every frame.
+struct StopSnapshot {
+    // Deeper stacks are truncated, the remaining frames are only reachable through the console
+    static constexpr uint32_t MAX_FRAMES_PER_THREAD = 4096;
+
+    uint32_t stop_id = 0;
+    lldb::StateType state = lldb::eStateInvalid;
+    size_t selected_thread = 0;  // index into threads
+    size_t changed_threads = 0;
+    std::vector<ThreadSnapshot> threads;
+
+    // With frames_on_demand only the selected thread's stack is walked up front, the others when
+    // load_frames is called for them. Unwinding thousands of threads of a core file can take minutes.
+    // Threads without a stop reason whose fingerprint didn't change since the previous stop take over
+    // its frames instead of being walked again, which leaves previous with empty stacks.
+    static StopSnapshot build(lldb::SBProcess process, bool frames_on_demand = false,
+                              StopSnapshot* previous = nullptr);
+    void load_frames(lldb::SBProcess process, size_t thread_index);
+};
+
+void dump(const StopSnapshot& snapshot, std::ostream& out);
+
+}  // namespace lldbg
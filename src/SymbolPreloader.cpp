@@ -0,0 +1,101 @@
+#include "SymbolPreloader.hpp"
+
+#include "Log.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace lldbg {
+
+unsigned SymbolPreloader::default_thread_count()
+{
+    // leave a core for the render thread and the event listener
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 2 ? std::min(cores - 1, 16u) : 1;
+}
+
+SymbolPreloader::SymbolPreloader(lldb::SBTarget target, unsigned num_threads)
+    : m_start(std::chrono::steady_clock::now())
+{
+    std::vector<std::pair<uintmax_t, lldb::SBModule>> modules;
+
+    const uint32_t num_modules = SB_CALL(Symbols, target.GetNumModules());
+    for (uint32_t i = 0; i < num_modules; i++) {
+        lldb::SBModule module = SB_CALL(Symbols, target.GetModuleAtIndex(i));
+        if (!module.IsValid()) {
+            continue;
+        }
+
+        char path[4096];
+        module.GetFileSpec().GetPath(path, sizeof(path));
+        std::error_code error;
+        const uintmax_t size = fs::file_size(path, error);
+        modules.emplace_back(error ? 0 : size, module);
+    }
+
+    std::stable_sort(modules.begin(), modules.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    m_modules.reserve(modules.size());
+    for (auto& module : modules) {
+        m_modules.push_back(std::move(module.second));
+    }
+
+    num_threads = std::max(1u, std::min(num_threads, (unsigned)m_modules.size()));
+    if (m_modules.empty()) {
+        return;
+    }
+
+    LOG(Debug) << "Preloading symbols of " << m_modules.size() << " modules on " << num_threads << " threads";
+
+    m_workers.reserve(num_threads);
+    for (unsigned i = 0; i < num_threads; i++) {
+        m_workers.emplace_back(&SymbolPreloader::work, this);
+    }
+}
+
+SymbolPreloader::~SymbolPreloader()
+{
+    m_cancelled.store(true);
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void SymbolPreloader::work()
+{
+    while (!m_cancelled.load(std::memory_order_relaxed)) {
+        const size_t index = m_next_module.fetch_add(1);
+        if (index >= m_modules.size()) {
+            return;
+        }
+
+        preload(m_modules[index]);
+
+        if (m_modules_done.fetch_add(1) + 1 == m_modules.size() && !m_cancelled.load()) {
+            const double elapsed_s =
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+            LOG(Info) << "Preloaded symbols of " << m_modules.size() << " modules (" << compile_units_done()
+                      << " compile units) in " << elapsed_s << " s";
+        }
+    }
+}
+
+void SymbolPreloader::preload(lldb::SBModule module)
+{
+    // builds the symbol table
+    SB_CALL(Symbols, module.GetNumSymbols());
+
+    // parses the debug info unit headers, then each unit's line table (loading .dwo files)
+    const uint32_t num_compile_units = SB_CALL(Symbols, module.GetNumCompileUnits());
+    for (uint32_t i = 0; i < num_compile_units && !m_cancelled.load(std::memory_order_relaxed); i++) {
+        lldb::SBCompileUnit compile_unit = SB_CALL(Symbols, module.GetCompileUnitAtIndex(i));
+        SB_CALL(Symbols, compile_unit.GetNumLineEntries());
+        m_compile_units_done.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace lldbg
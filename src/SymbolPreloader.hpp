@@ -0,0 +1,50 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace lldbg {
+
+// LLDB parses symbol tables and debug info lazily, the first time something needs them, which
+// is usually the render thread resolving a breakpoint or a stop location. For large binaries
+// (especially with split DWARF) that is a stall of many seconds. This parses the symbol table and
+// every compile unit's line table of all of a target's modules up front, on a pool of threads,
+// so that those later lookups find everything already loaded.
+class SymbolPreloader final {
+    std::vector<lldb::SBModule> m_modules;  // largest file first, so that the pool finishes together
+    std::vector<std::thread> m_workers;
+    std::chrono::steady_clock::time_point m_start;
+
+    std::atomic<size_t> m_next_module = {0};
+    std::atomic<size_t> m_modules_done = {0};
+    std::atomic<size_t> m_compile_units_done = {0};
+    std::atomic<bool> m_cancelled = {false};
+
+    void work();
+    void preload(lldb::SBModule module);
+
+public:
+    static unsigned default_thread_count();
+
+    // Starts preloading the modules the target has now, i.e. the executable and the libraries it
+    // depends on. Libraries loaded later with dlopen are parsed lazily as usual.
+    SymbolPreloader(lldb::SBTarget target, unsigned num_threads);
+
+    // Cancellation takes effect between compile units, so it may wait for one to finish parsing
+    ~SymbolPreloader();
+
+    SymbolPreloader(const SymbolPreloader&) = delete;
+    SymbolPreloader& operator=(const SymbolPreloader&) = delete;
+
+    size_t modules_total() const { return m_modules.size(); }
+    size_t modules_done() const { return m_modules_done.load(std::memory_order_relaxed); }
+    size_t compile_units_done() const { return m_compile_units_done.load(std::memory_order_relaxed); }
+    bool finished() const { return modules_done() == modules_total(); }
+};
+
+}  // namespace lldbg
@@ -0,0 +1,160 @@
+#include "ThreadGroups.hpp"
+
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// FNV-1a over the bytes of every pc
+uint64_t hash_stack(const std::vector<uint64_t>& pcs)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (uint64_t pc : pcs) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (pc >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+struct ThreadStack {
+    uint64_t thread_id = 0;
+    bool walked = false;  // whether pcs are already known from the snapshot
+    std::vector<uint64_t> pcs;
+};
+
+std::optional<lldbg::ThreadGrouping> group_threads(lldb::SBProcess process, uint32_t stop_id,
+                                                   std::vector<ThreadStack> stacks,
+                                                   std::shared_ptr<std::atomic<bool>> cancelled)
+{
+    lldbg::ThreadGrouping grouping;
+    grouping.stop_id = stop_id;
+
+    std::unordered_multimap<uint64_t, size_t> groups_by_hash;
+
+    for (size_t i = 0; i < stacks.size(); i++) {
+        if (cancelled->load(std::memory_order_relaxed)) {
+            return {};
+        }
+
+        ThreadStack& stack = stacks[i];
+        if (!stack.walked) {
+            lldb::SBThread thread = SB_CALL(Thread, process.GetThreadByID(stack.thread_id));
+            const uint32_t num_frames =
+                std::min(SB_CALL(Thread, thread.GetNumFrames()), lldbg::StopSnapshot::MAX_FRAMES_PER_THREAD);
+            stack.pcs.reserve(num_frames);
+            for (uint32_t j = 0; j < num_frames; j++) {
+                stack.pcs.push_back(SB_CALL(Frame, thread.GetFrameAtIndex(j).GetPC()));
+            }
+        }
+
+        // equal hashes are only grouped when the stacks really are equal
+        const uint64_t hash = hash_stack(stack.pcs);
+        std::optional<size_t> group_index;
+        auto range = groups_by_hash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (grouping.groups[it->second].pcs == stack.pcs) {
+                group_index = it->second;
+                break;
+            }
+        }
+
+        if (!group_index) {
+            group_index = grouping.groups.size();
+            groups_by_hash.emplace(hash, *group_index);
+            lldbg::ThreadGroup group;
+            group.stack_hash = hash;
+            group.pcs = std::move(stack.pcs);
+            grouping.groups.push_back(std::move(group));
+        }
+        grouping.groups[*group_index].threads.push_back(i);
+    }
+
+    std::stable_sort(grouping.groups.begin(), grouping.groups.end(),
+                     [](const lldbg::ThreadGroup& a, const lldbg::ThreadGroup& b) {
+                         return a.threads.size() > b.threads.size();
+                     });
+
+    // only the innermost pc of each group is symbolicated, enough to label it while collapsed
+    lldb::SBTarget target = process.GetTarget();
+    for (lldbg::ThreadGroup& group : grouping.groups) {
+        if (cancelled->load(std::memory_order_relaxed)) {
+            return {};
+        }
+        if (group.pcs.empty()) {
+            continue;
+        }
+
+        lldb::SBAddress address = SB_CALL(Symbols, target.ResolveLoadAddress(group.pcs.front()));
+        lldb::SBFunction function = SB_CALL(Symbols, address.GetFunction());
+        const char* name = function.IsValid() ? function.GetDisplayName()
+                                              : SB_CALL(Symbols, address.GetSymbol()).GetDisplayName();
+        if (name) {
+            group.function_name = name;
+        }
+    }
+
+    return grouping;
+}
+
+}  // namespace
+
+namespace lldbg {
+
+ThreadGrouper::~ThreadGrouper() { cancel(); }
+
+const ThreadGrouping* ThreadGrouper::get(lldb::SBProcess process, const StopSnapshot& snapshot)
+{
+    if (m_latest && m_latest->stop_id == snapshot.stop_id) {
+        return &*m_latest;
+    }
+
+    if (m_pending.valid() && m_pending_stop_id == snapshot.stop_id) {
+        if (m_pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return nullptr;
+        }
+
+        m_latest = m_pending.get();
+        return m_latest && m_latest->stop_id == snapshot.stop_id ? &*m_latest : nullptr;
+    }
+
+    cancel();
+    m_latest.reset();
+
+    PROFILE_SCOPE("ThreadGrouper::start");
+
+    std::vector<ThreadStack> stacks(snapshot.threads.size());
+    for (size_t i = 0; i < snapshot.threads.size(); i++) {
+        const ThreadSnapshot& thread = snapshot.threads[i];
+        stacks[i].thread_id = thread.thread_id;
+        stacks[i].walked = thread.frames_loaded;
+        if (thread.frames_loaded) {
+            stacks[i].pcs.reserve(thread.frames.size());
+            for (const FrameSnapshot& frame : thread.frames) {
+                stacks[i].pcs.push_back(frame.pc);
+            }
+        }
+    }
+
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_pending_stop_id = snapshot.stop_id;
+    m_pending = std::async(std::launch::async, group_threads, process, snapshot.stop_id, std::move(stacks),
+                           m_cancelled);
+
+    return nullptr;
+}
+
+void ThreadGrouper::cancel()
+{
+    if (m_pending.valid()) {
+        m_cancelled->store(true);
+        m_pending.wait();
+        m_pending = {};
+    }
+}
+
+}  // namespace lldbg
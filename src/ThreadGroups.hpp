@@ -0,0 +1,55 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include "StopSnapshot.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lldbg {
+
+// Threads whose stacks have exactly the same pcs, e.g. idle workers of a thread pool
+struct ThreadGroup {
+    uint64_t stack_hash = 0;
+    std::vector<uint64_t> pcs;    // the shared stack, innermost frame first
+    std::string function_name;    // of the innermost pc, empty when unknown
+    std::vector<size_t> threads;  // indices into StopSnapshot::threads, ascending
+};
+
+struct ThreadGrouping {
+    uint32_t stop_id = 0;
+    std::vector<ThreadGroup> groups;  // largest first
+};
+
+// Aggregates the threads of a stop by stack, like pstack or eu-stack do, on a background thread.
+// Stacks that the StopSnapshot already has are hashed as they are, the others (core files) are
+// walked for their pcs only, and only the innermost pc of each group is resolved to a function.
+class ThreadGrouper final {
+    std::future<std::optional<ThreadGrouping>> m_pending;
+    uint32_t m_pending_stop_id = 0;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    std::optional<ThreadGrouping> m_latest;
+
+public:
+    ThreadGrouper() = default;
+    ~ThreadGrouper();
+
+    ThreadGrouper(const ThreadGrouper&) = delete;
+    ThreadGrouper& operator=(const ThreadGrouper&) = delete;
+
+    // Starts grouping the snapshot's threads unless that is already done or underway, returns
+    // the grouping once it is ready
+    const ThreadGrouping* get(lldb::SBProcess process, const StopSnapshot& snapshot);
+
+    // Abandons any grouping underway, waiting for it to notice. Must be called when the process
+    // resumes (a stack walked while running is meaningless) and before the target is deleted.
+    void cancel();
+};
+
+}  // namespace lldbg
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 class Timer final {
     using Clock = std::chrono::high_resolution_clock;
@@ -0,0 +1,106 @@
+#include "Watchpoints.hpp"
+
+#include "Prelude.hpp"
+#include "Profiler.hpp"
+#include "SBTrace.hpp"
+
+#include <unordered_set>
+
+namespace {
+
+bool same_description(const lldbg::WatchpointDescription& a, const lldbg::WatchpointDescription& b)
+{
+    return a.id == b.id && a.address == b.address && a.size == b.size && a.enabled == b.enabled &&
+           a.hardware_index == b.hardware_index && a.hit_count == b.hit_count &&
+           a.ignore_count == b.ignore_count && a.condition == b.condition && a.label == b.label &&
+           a.kind == b.kind;
+}
+
+}  // namespace
+
+namespace lldbg {
+
+const char* watch_kind_name(WatchKind kind)
+{
+    switch (kind) {
+        case WatchKind::Write:
+            return "write";
+        case WatchKind::Read:
+            return "read";
+        case WatchKind::ReadWrite:
+            return "read/write";
+        case WatchKind::Unknown:
+            break;
+    }
+    return "?";
+}
+
+void WatchpointTable::synchronize(lldb::SBTarget target)
+{
+    PROFILE_SCOPE("WatchpointTable::synchronize");
+
+    std::vector<WatchpointDescription> watchpoints;
+    std::unordered_set<lldb::watch_id_t> live_ids;
+
+    const uint32_t num_watchpoints = target.IsValid() ? SB_CALL(Watchpoint, target.GetNumWatchpoints()) : 0;
+    watchpoints.reserve(num_watchpoints);
+
+    for (uint32_t i = 0; i < num_watchpoints; i++) {
+        lldb::SBWatchpoint watchpoint = SB_CALL(Watchpoint, target.GetWatchpointAtIndex(i));
+        if (!watchpoint.IsValid()) {
+            continue;
+        }
+
+        WatchpointDescription description;
+        description.id = SB_CALL(Watchpoint, watchpoint.GetID());
+        description.address = SB_CALL(Watchpoint, watchpoint.GetWatchAddress());
+        description.size = SB_CALL(Watchpoint, watchpoint.GetWatchSize());
+        description.enabled = SB_CALL(Watchpoint, watchpoint.IsEnabled());
+        description.hardware_index = SB_CALL(Watchpoint, watchpoint.GetHardwareIndex());
+        description.hit_count = SB_CALL(Watchpoint, watchpoint.GetHitCount());
+        description.ignore_count = SB_CALL(Watchpoint, watchpoint.GetIgnoreCount());
+        description.condition = build_string(SB_CALL(Watchpoint, watchpoint.GetCondition()));
+
+        auto origin = m_origins.find(description.id);
+        if (origin != m_origins.end()) {
+            description.label = origin->second.label;
+            description.kind = origin->second.kind;
+        }
+
+        live_ids.insert(description.id);
+        watchpoints.push_back(std::move(description));
+    }
+
+    for (auto it = m_origins.begin(); it != m_origins.end();) {
+        if (live_ids.count(it->first) == 0) {
+            it = m_origins.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    bool changed = watchpoints.size() != m_watchpoints.size();
+    for (size_t i = 0; !changed && i < watchpoints.size(); i++) {
+        changed = !same_description(watchpoints[i], m_watchpoints[i]);
+    }
+
+    if (changed) {
+        m_watchpoints = std::move(watchpoints);
+        m_version++;
+    }
+}
+
+void WatchpointTable::remember_origin(lldb::watch_id_t id, const std::string& label, WatchKind kind)
+{
+    m_origins[id] = Origin{label, kind};
+}
+
+void WatchpointTable::clear()
+{
+    m_watchpoints.clear();
+    m_origins.clear();
+    m_version++;
+}
+
+}  // namespace lldbg
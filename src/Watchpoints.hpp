@@ -0,0 +1,52 @@
+#pragma once
+
+#include "lldb/API/LLDB.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lldbg {
+
+enum class WatchKind { Write, Read, ReadWrite, Unknown };
+
+const char* watch_kind_name(WatchKind kind);
+
+struct WatchpointDescription {
+    lldb::watch_id_t id = 0;
+    uint64_t address = 0;
+    size_t size = 0;
+    bool enabled = false;
+    int32_t hardware_index = -1;  // -1 when not currently installed in a debug register
+    uint32_t hit_count = 0;
+    uint32_t ignore_count = 0;
+    std::string condition;
+    std::string label;  // what is being watched, e.g. a variable name
+    WatchKind kind = WatchKind::Unknown;
+};
+
+// The target's watchpoints, copied out of LLDB when they change (watchpoint events) and when the
+// process stops (hit counts), so that the Watchpoints pane doesn't walk the SB API every frame.
+class WatchpointTable final {
+    struct Origin {
+        std::string label;
+        WatchKind kind = WatchKind::Unknown;
+    };
+
+    std::vector<WatchpointDescription> m_watchpoints;
+    std::unordered_map<lldb::watch_id_t, Origin> m_origins;  // only known for watchpoints made by lldbg
+    uint64_t m_version = 0;
+
+public:
+    void synchronize(lldb::SBTarget target);
+    void remember_origin(lldb::watch_id_t id, const std::string& label, WatchKind kind);
+    void clear();
+
+    const std::vector<WatchpointDescription>& watchpoints() const { return m_watchpoints; }
+
+    // incremented on every synchronization that changed the table
+    uint64_t version() const { return m_version; }
+};
+
+}  // namespace lldbg
@@ -7,48 +7,160 @@
 #include "Draw.hpp"
 #include "FileSystem.hpp"
 #include "Log.hpp"
+#include "Startup.hpp"
 #include "Timer.hpp"
 
 #include <GL/freeglut.h>
+#include "cxxopts.hpp"
 #include "examples/imgui_impl_freeglut.h"
 #include "examples/imgui_impl_opengl2.h"
 #include "imgui.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
+#include <iterator>
 #include <string>
 #include <vector>
 
-int main(int argc, char** argv)
+namespace {
+
+// Moves the X11 options glutInit understands out of argv (up to a "--") into the returned
+// arguments for it, which keep argv[0]. Left in, cxxopts would reject them as unknown.
+std::vector<char*> take_glut_options(int& argc, char** argv)
 {
-    lldbg::g_application = std::make_unique<lldbg::Application>(&argc, argv);
-    lldbg::g_logger = std::make_unique<lldbg::Logger>();
+    // the command line options of freeglut
+    static const char* const WITH_VALUE[] = {"-display", "-geometry"};
+    static const char* const WITHOUT_VALUE[] = {"-direct", "-indirect", "-iconic", "-gldebug", "-sync"};
 
-    std::vector<std::string> args(argv + 1, argv + argc);
-    std::vector<const char*> const_argv;
+    std::vector<char*> glut_argv = {argv[0]};
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--") {
+            while (i < argc) {
+                argv[kept++] = argv[i++];
+            }
+            break;
+        }
 
-    for (const std::string& arg : args) {
-        const_argv.push_back(arg.c_str());
+        const bool with_value = std::find(std::begin(WITH_VALUE), std::end(WITH_VALUE), arg) != std::end(WITH_VALUE);
+        if (with_value && i + 1 < argc) {
+            glut_argv.push_back(argv[i++]);
+            glut_argv.push_back(argv[i]);
+        }
+        else if (std::find(std::begin(WITHOUT_VALUE), std::end(WITHOUT_VALUE), arg) != std::end(WITHOUT_VALUE)) {
+            glut_argv.push_back(argv[i]);
+        }
+        else {
+            argv[kept++] = argv[i];
+        }
     }
+    argc = kept;
+    argv[argc] = nullptr;
+
+    glut_argv.push_back(nullptr);
+    return glut_argv;
+}
+
+std::optional<lldbg::StartupOptions> parse_options(int& argc, char**& argv)
+{
+    cxxopts::Options options("lldbg", "A graphical front end for lldb");
+    options.positional_help("[EXECUTABLE] [-- ARGS...]");
+    options.add_options()
+        ("h,help", "Print this help")
+        ("w,workdir", "Working directory of the debugged project", cxxopts::value<std::string>(), "DIR")
+        ("c,core", "Open a core dump of EXECUTABLE instead of launching it", cxxopts::value<std::string>(), "CORE")
+        ("p,attach-pid", "Attach to a running process", cxxopts::value<uint64_t>(), "PID")
+        ("n,attach-name", "Attach to the running process with this name", cxxopts::value<std::string>(), "NAME")
+        ("wait-for", "With --attach-name, wait for the process to be launched")
+        ("j,symbol-threads", "Threads preloading symbols of new targets, 0 to disable",
+         cxxopts::value<unsigned>(), "THREADS");
+    options.add_options("positional")
+        ("executable", "", cxxopts::value<std::string>())
+        ("args", "", cxxopts::value<std::vector<std::string>>());
+    options.parse_positional({"executable", "args"});
+
+    try {
+        cxxopts::ParseResult result = options.parse(argc, argv);
+
+        if (result.count("help")) {
+            std::cout << options.help({""}) << std::endl;
+            exit(0);
+        }
 
-    const char** const_argv_ptr = const_argv.data();
+        lldbg::StartupOptions startup;
+        if (result.count("executable")) {
+            startup.executable = result["executable"].as<std::string>();
+        }
+        if (result.count("args")) {
+            startup.args = result["args"].as<std::vector<std::string>>();
+        }
+        if (result.count("workdir")) {
+            startup.workdir = result["workdir"].as<std::string>();
+        }
+        if (result.count("core")) {
+            startup.core_file = result["core"].as<std::string>();
+        }
+        if (result.count("attach-pid")) {
+            startup.attach_pid = (lldb::pid_t)result["attach-pid"].as<uint64_t>();
+        }
+        if (result.count("attach-name")) {
+            startup.attach_name = result["attach-name"].as<std::string>();
+        }
+        startup.wait_for_launch = result.count("wait-for") > 0;
+        if (result.count("symbol-threads")) {
+            startup.symbol_preload_threads = result["symbol-threads"].as<unsigned>();
+        }
 
-    auto err = lldbg::create_new_target(*lldbg::g_application, "/home/zac/lldbg/test/a.out", const_argv_ptr,
-                                        true, "/home/zac/lldbg/test/");
+        if (startup.core_file && !startup.executable) {
+            std::cerr << "--core requires an EXECUTABLE" << std::endl;
+            return {};
+        }
 
-    if (err) {
-        std::cout << err->msg << std::endl;
+        return startup;
+    }
+    catch (const cxxopts::OptionException& e) {
+        std::cerr << e.what() << '\n' << options.help({""}) << std::endl;
+        return {};
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::vector<char*> glut_argv = take_glut_options(argc, argv);
+    int glut_argc = (int)glut_argv.size() - 1;
+
+    std::optional<lldbg::StartupOptions> options = parse_options(argc, argv);
+    if (!options) {
         return 1;
     }
 
+    lldbg::g_logger = std::make_unique<lldbg::Logger>();
+
+    // LLDB is initialized and the target launched while the window is already being drawn
+    lldbg::g_pending_application = lldbg::start_application(std::move(*options));
+
+    lldbg::g_ui = std::make_unique<lldbg::UserInterface>(&glut_argc, glut_argv.data());
+    lldbg::g_startup_timeline.reach(lldbg::StartupMilestone::WindowCreated);
+
     ImGuiIO& io = ImGui::GetIO();
     io.Fonts->AddFontDefault();
     // TODO: read font path from CMake-defined variable
-    lldbg::g_application->render_state.font =
+    lldbg::g_ui->font =
         io.Fonts->AddFontFromFileTTF("../lib/imgui/misc/fonts/Hack-Regular.ttf", 15.0f);
 
     glutMainLoop();
 
+    // the window may have been closed before LLDB finished starting up
+    if (lldbg::g_pending_application.valid()) {
+        lldbg::g_application = lldbg::g_pending_application.get();
+    }
+
     // NOTE: important to destruct these in order, for now (bad design)
+    lldbg::g_ui.reset(nullptr);
     lldbg::g_application.reset(nullptr);
     lldbg::g_logger.reset(nullptr);
 
@@ -0,0 +1,16 @@
+#pragma once
+
+// Shared by the stress inferiors: the benchmarks and the headless driver set a breakpoint on
+// lldbg_stress_break, which each program calls once its interesting state has been set up.
+
+#include <cstdlib>
+
+extern "C" __attribute__((noinline)) inline void lldbg_stress_break()
+{
+    asm volatile("" ::: "memory");
+}
+
+inline long stress_arg(int argc, char** argv, int index, long default_value)
+{
+    return argc > index ? strtol(argv[index], nullptr, 10) : default_value;
+}
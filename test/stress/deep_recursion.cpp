@@ -0,0 +1,53 @@
+// Recurses 100k frames deep (or as deep as the first argument says) on a thread with a large
+// stack, then calls lldbg_stress_break() from the deepest frame.
+
+#include "Stress.hpp"
+
+#include <pthread.h>
+#include <cstdio>
+
+namespace {
+
+constexpr size_t STACK_SIZE = 512 * 1024 * 1024;
+
+__attribute__((noinline)) long recurse(long depth, long remaining)
+{
+    volatile long local = depth;
+
+    if (remaining == 0) {
+        lldbg_stress_break();
+        return local;
+    }
+
+    // not a tail call, so every level keeps its frame
+    return recurse(depth + 1, remaining - 1) + local;
+}
+
+void* recursion_thread(void* arg)
+{
+    const long depth = *static_cast<long*>(arg);
+    printf("%ld\n", recurse(0, depth));
+    return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    long depth = stress_arg(argc, argv, 1, 100000);
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, STACK_SIZE);
+
+    pthread_t thread;
+    if (pthread_create(&thread, &attributes, recursion_thread, &depth) != 0) {
+        perror("pthread_create");
+        return 1;
+    }
+
+    pthread_join(thread, nullptr);
+    pthread_attr_destroy(&attributes);
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Calls lldbg_stress_break() from a frame whose locals are expensive to display: large arrays,
+// deeply nested structs and big STL containers. The first argument scales the containers.
+
+#include "Stress.hpp"
+
+#include <array>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+template <int DEPTH>
+struct Nested {
+    int value = DEPTH;
+    double weights[4] = {0.25 * DEPTH, 0.5 * DEPTH, 0.75 * DEPTH, 1.0 * DEPTH};
+    Nested<DEPTH - 1> inner;
+};
+
+template <>
+struct Nested<0> {
+    int value = 0;
+};
+
+struct Particle {
+    double position[3];
+    double velocity[3];
+    int id;
+    std::string name;
+};
+
+__attribute__((noinline)) long inspect_me(long scale)
+{
+    std::array<int, 256 * 1024> big_array;
+    for (size_t i = 0; i < big_array.size(); i++) {
+        big_array[i] = (int)i;
+    }
+
+    char text[64 * 1024];
+    for (size_t i = 0; i < sizeof(text); i++) {
+        text[i] = (char)('a' + i % 26);
+    }
+    text[sizeof(text) - 1] = '\0';
+
+    Nested<64> nested;
+
+    std::vector<int> numbers(scale * 100);
+    for (size_t i = 0; i < numbers.size(); i++) {
+        numbers[i] = (int)(i * 7);
+    }
+
+    std::vector<std::string> strings;
+    for (long i = 0; i < scale * 10; i++) {
+        strings.push_back("string number " + std::to_string(i));
+    }
+
+    std::map<int, std::string> ordered;
+    std::unordered_map<std::string, std::vector<int>> hashed;
+    for (long i = 0; i < scale; i++) {
+        ordered[(int)i] = std::to_string(i * i);
+        hashed["key " + std::to_string(i)] = std::vector<int>(i % 16, (int)i);
+    }
+
+    std::vector<Particle> particles(scale);
+    for (long i = 0; i < scale; i++) {
+        particles[i] = Particle{{1.0 * i, 2.0 * i, 3.0 * i}, {0.1, 0.2, 0.3}, (int)i, "particle " + std::to_string(i)};
+    }
+
+    lldbg_stress_break();
+
+    return big_array[scale % big_array.size()] + text[0] + nested.inner.value + (long)numbers.size() +
+           (long)strings.size() + (long)ordered.size() + (long)hashed.size() + (long)particles.size();
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    return inspect_me(stress_arg(argc, argv, 1, 100000)) == 0;
+}
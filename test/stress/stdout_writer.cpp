@@ -0,0 +1,26 @@
+// Writes lines to stdout (and every hundredth to stderr) as fast as possible, to stress the
+// handling of inferior output. The first argument is the number of lines (default one million),
+// lldbg_stress_break() is called before the first and after the last line.
+
+#include "Stress.hpp"
+
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+    const long num_lines = stress_arg(argc, argv, 1, 1000000);
+
+    lldbg_stress_break();
+
+    for (long i = 0; i < num_lines; i++) {
+        printf("line %ld: the quick brown fox jumps over the lazy dog\n", i);
+        if (i % 100 == 0) {
+            fprintf(stderr, "progress: %ld/%ld\n", i, num_lines);
+        }
+    }
+    fflush(stdout);
+
+    lldbg_stress_break();
+
+    return 0;
+}
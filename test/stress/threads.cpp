@@ -0,0 +1,54 @@
+// LLDBG_STRESS_THREADS threads (overridable with the first argument), each a few frames deep,
+// that all call lldbg_stress_break() once every thread has started.
+
+#include "Stress.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifndef LLDBG_STRESS_THREADS
+#define LLDBG_STRESS_THREADS 100
+#endif
+
+namespace {
+
+std::atomic<long> s_started = {0};
+
+__attribute__((noinline)) int worker_frame(long thread_index, int depth, long num_threads)
+{
+    if (depth > 0) {
+        return worker_frame(thread_index, depth - 1, num_threads) + 1;
+    }
+
+    s_started++;
+    while (s_started.load() < num_threads) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    lldbg_stress_break();
+
+    // stay alive so that the threads are still there when the debugger inspects the process
+    std::this_thread::sleep_for(std::chrono::seconds(60));
+    return (int)thread_index;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const long num_threads = stress_arg(argc, argv, 1, LLDBG_STRESS_THREADS);
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (long i = 0; i < num_threads; i++) {
+        threads.emplace_back([i, num_threads] { worker_frame(i, (int)(i % 8), num_threads); });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return 0;
+}
@@ -0,0 +1,456 @@
+// Drives the lldbg debugger model without GLUT or OpenGL, for scripted sessions and
+// performance regression runs on machines without a display.
+//
+//   lldbg_headless -b main.cpp:12 -x next -x dump -x "frame variable" ./a.out arg1 arg2
+
+#include "lldb/API/LLDB.h"
+
+#include "Application.hpp"
+#include "Log.hpp"
+#include "StopSnapshot.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct HeadlessOptions {
+    std::optional<std::string> workdir;
+    std::vector<std::pair<std::string, int>> breakpoints;
+    std::vector<std::string> commands;
+    std::chrono::milliseconds stop_timeout = std::chrono::milliseconds(10000);
+    std::vector<std::string> target;  // executable followed by its arguments
+    std::optional<lldb::pid_t> attach_pid;
+    std::optional<std::string> attach_name;
+    std::optional<std::string> core_file;
+    std::optional<unsigned> symbol_preload_threads;
+};
+
+void print_usage()
+{
+    std::cerr << "usage: lldbg_headless [options] EXECUTABLE [ARGS...]\n"
+                 "       lldbg_headless [options] -p PID | -n NAME\n"
+                 "       lldbg_headless [options] -c CORE EXECUTABLE\n"
+                 "  -w DIR          working directory of the debugged project\n"
+                 "  -b FILE:LINE    set a breakpoint before running (repeatable)\n"
+                 "  -x COMMAND      run COMMAND after the process stops at entry (repeatable, in order).\n"
+                 "                  next, step, finish and continue resume the process and wait for the\n"
+                 "                  next stop, dump prints the stopped state, registers prints the\n"
+                 "                  registers of the selected thread (* marks changes since the last\n"
+                 "                  stop), groups prints the threads aggregated by identical stacks,\n"
+                 "                  'steps N' steps over N times back to back as holding F10 does,\n"
+                 "                  breakpoints prints every breakpoint with its hit and stop statistics,\n"
+                 "                  anything else is passed to the lldb command interpreter\n"
+                 "  -t MS           how long to wait for each stop (default 10000)\n"
+                 "  -p PID          attach to a running process instead of launching one\n"
+                 "  -n NAME         attach to the process called NAME, waiting for it to launch\n"
+                 "  -c CORE         open a core dump of EXECUTABLE, only the crashed thread's stack is\n"
+                 "                  walked\n"
+                 "  -j THREADS      threads preloading symbols after target creation, 0 to disable\n";
+}
+
+std::optional<HeadlessOptions> parse_options(int argc, char** argv)
+{
+    HeadlessOptions options;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        const std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "missing value for " << flag << '\n';
+            return {};
+        }
+        const char* value = argv[++i];
+
+        if (flag == "-w") {
+            options.workdir = value;
+        }
+        else if (flag == "-b") {
+            const char* colon = strrchr(value, ':');
+            if (!colon) {
+                std::cerr << "expected FILE:LINE, got " << value << '\n';
+                return {};
+            }
+            options.breakpoints.emplace_back(std::string(value, colon), atoi(colon + 1));
+        }
+        else if (flag == "-x") {
+            options.commands.push_back(value);
+        }
+        else if (flag == "-t") {
+            options.stop_timeout = std::chrono::milliseconds(atol(value));
+        }
+        else if (flag == "-p") {
+            options.attach_pid = (lldb::pid_t)strtoull(value, nullptr, 10);
+        }
+        else if (flag == "-n") {
+            options.attach_name = value;
+        }
+        else if (flag == "-c") {
+            options.core_file = value;
+        }
+        else if (flag == "-j") {
+            options.symbol_preload_threads = (unsigned)atoi(value);
+        }
+        else {
+            std::cerr << "unknown option " << flag << '\n';
+            return {};
+        }
+    }
+
+    if (options.attach_pid || options.attach_name) {
+        return i == argc ? std::optional<HeadlessOptions>(options) : std::nullopt;
+    }
+
+    if (i == argc) {
+        return {};
+    }
+
+    options.target.assign(argv + i, argv + argc);
+    return options;
+}
+
+void print_log_messages()
+{
+    lldbg::g_logger->drain();
+
+    static uint64_t next_message = 0;
+    for (; next_message < lldbg::g_logger->message_count(); next_message++) {
+        if (next_message < lldbg::g_logger->first_message_index()) {
+            continue;
+        }
+        const lldbg::LogMessage& message = lldbg::g_logger->message(next_message);
+        std::cerr << "[" << lldbg::log_level_name(message.level) << "] " << message.message << '\n';
+    }
+}
+
+bool resume_and_wait(lldbg::Application& app, const std::string& command, std::chrono::milliseconds timeout)
+{
+    // kept for the next stop to be diffed against, as the process events would
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (session->stop_snapshot) {
+        session->previous_snapshot = std::move(session->stop_snapshot);
+        session->stop_snapshot.reset();
+    }
+
+    Timer timer;
+    if (command == "next") {
+        lldbg::step_over(app);
+    }
+    else if (command == "step") {
+        lldbg::step_into(app);
+    }
+    else if (command == "finish") {
+        lldbg::step_out(app);
+    }
+    else {
+        lldbg::continue_process(app);
+    }
+
+    const bool stopped = lldbg::wait_for_stop(app, timeout);
+    const double elapsed_ms = (double)timer.elapsed_ns() / 1e6;
+
+    if (stopped) {
+        const lldbg::StopSnapshot& snapshot = *session->stop_snapshot;
+        std::cout << "[lldbg] " << command << ": stopped after " << elapsed_ms << " ms, " << snapshot.changed_threads
+                  << " of " << snapshot.threads.size() << " threads changed\n";
+    }
+    else if (app.exit_dialog) {
+        std::cout << "[lldbg] " << command << ": process exited with status " << app.exit_dialog->exit_code
+                  << " after " << elapsed_ms << " ms\n";
+    }
+    else {
+        std::cout << "[lldbg] " << command << ": timed out waiting for the process to stop\n";
+    }
+
+    return stopped;
+}
+
+bool rapid_step_and_wait(lldbg::Application& app, uint32_t count, std::chrono::milliseconds timeout)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    const uint64_t steps_before = session->rapid_step.steps_taken;
+
+    Timer timer;
+    lldbg::queue_steps(app, lldbg::StepKind::Over, count);
+    if (session->stop_snapshot) {
+        session->previous_snapshot = std::move(session->stop_snapshot);
+        session->stop_snapshot.reset();
+    }
+    const bool stopped = lldbg::wait_for_stop(app, timeout);
+    const double elapsed_ms = (double)timer.elapsed_ns() / 1e6;
+
+    const uint64_t steps = session->rapid_step.steps_taken - steps_before;
+    std::cout << "[lldbg] steps: " << steps << " of " << count << " steps in " << elapsed_ms << " ms ("
+              << (elapsed_ms > 0 ? (double)steps * 1e3 / elapsed_ms : 0) << " steps/s)";
+    if (session->rapid_step.location) {
+        std::cout << ", at " << session->rapid_step.location->file_name << ':' << session->rapid_step.location->line;
+    }
+    std::cout << '\n';
+
+    return stopped;
+}
+
+void dump_state(lldbg::Application& app)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (!session || !session->stop_snapshot) {
+        std::cout << "[lldbg] dump: process is not stopped\n";
+        return;
+    }
+
+    // rebuilt rather than reusing the current snapshot, so that construction can be timed
+    Timer timer;
+    const lldbg::StopSnapshot snapshot = lldbg::StopSnapshot::build(lldbg::get_process(app), session->is_core);
+    const uint64_t build_ns = timer.elapsed_ns();
+
+    lldbg::dump(snapshot, std::cout);
+    std::cout << "[lldbg] dump: snapshot built in " << (double)build_ns / 1e3 << " us\n";
+}
+
+void dump_registers(lldbg::Application& app)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (!session || !session->stop_snapshot || session->stop_snapshot->threads.empty()) {
+        std::cout << "[lldbg] registers: process is not stopped\n";
+        return;
+    }
+
+    // already read when the process stopped, so reading them is timed again separately
+    const lldbg::StopSnapshot& snapshot = *session->stop_snapshot;
+    lldb::SBProcess process = session->target.GetProcess();
+    const lldbg::RegisterSnapshot& registers = session->registers.get(process, snapshot, snapshot.selected_thread, 0);
+
+    Timer timer;
+    lldbg::RegisterSnapshot::build(process.GetThreadByID(registers.thread_id).GetFrameAtIndex(0));
+    const uint64_t read_ns = timer.elapsed_ns();
+
+    for (const lldbg::RegisterSetRange& set : registers.sets) {
+        std::cout << set.name << '\n';
+        for (size_t i = set.begin; i < set.end; i++) {
+            const lldbg::RegisterValue& value = registers.registers[i];
+            std::cout << (value.changed ? "* " : "  ") << value.name << " = "
+                      << (value.is_vector ? lldbg::format_lanes(value.bytes, lldbg::LaneFormat::Hex32) : value.value)
+                      << '\n';
+        }
+    }
+    std::cout << "[lldbg] registers: " << registers.num_changed << " changed, read in " << (double)read_ns / 1e3
+              << " us\n";
+}
+
+void run_console_command(lldbg::Application& app, const std::string& command)
+{
+    const lldbg::LineBuffer& history = app.command_line.get_history();
+    const size_t first_new_line = history.line_count();
+
+    lldbg::run_lldb_command(app, command.c_str());
+
+    for (size_t i = std::min(first_new_line, history.line_count()); i < history.line_count(); i++) {
+        std::cout.write(history.line_begin(i), history.line_end(i) - history.line_begin(i));
+        std::cout << '\n';
+    }
+
+    lldbg::process_events(app);
+}
+
+void dump_breakpoints(lldbg::Application& app)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (!session) {
+        std::cout << "[lldbg] breakpoints: no target\n";
+        return;
+    }
+
+    const lldbg::BreakpointTable& table = session->breakpoint_table;
+    for (const lldbg::BreakpointDescription& breakpoint : table.breakpoints()) {
+        std::cout << breakpoint.id << ": " << (breakpoint.enabled ? "" : "(disabled) ");
+        if (breakpoint.file_name.empty()) {
+            std::cout << breakpoint.num_locations << " locations";
+        }
+        else {
+            std::cout << breakpoint.file_name << ':' << breakpoint.line;
+        }
+        std::cout << " hits=" << breakpoint.hit_count << " (" << breakpoint.hits_per_second << "/s)"
+                  << " stops=" << breakpoint.stops << " stopped=" << (double)breakpoint.stopped_ns / 1e6 << " ms";
+        if (breakpoint.ignore_count > 0) {
+            std::cout << " ignore=" << breakpoint.ignore_count;
+        }
+        if (!breakpoint.condition.empty()) {
+            std::cout << " condition=" << breakpoint.condition;
+        }
+        std::cout << '\n';
+    }
+    std::cout << "[lldbg] breakpoints: " << table.breakpoints().size() << " breakpoints, " << table.auto_resumes()
+              << " automatic resumes (" << table.auto_resumes_per_second() << "/s in the last run)\n";
+}
+
+void dump_thread_groups(lldbg::Application& app)
+{
+    lldbg::TargetSession* session = lldbg::selected_session(app);
+    if (!session || !session->stop_snapshot) {
+        std::cout << "[lldbg] groups: process is not stopped\n";
+        return;
+    }
+
+    lldbg::StopSnapshot& snapshot = *session->stop_snapshot;
+    lldb::SBProcess process = session->target.GetProcess();
+
+    Timer timer;
+    const lldbg::ThreadGrouping* grouping = nullptr;
+    while (!(grouping = session->thread_groups.get(process, snapshot))) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const uint64_t group_ns = timer.elapsed_ns();
+
+    for (const lldbg::ThreadGroup& group : grouping->groups) {
+        snapshot.load_frames(process, group.threads.front());
+        std::cout << group.threads.size() << " threads:\n";
+        for (const lldbg::FrameSnapshot& frame : snapshot.threads[group.threads.front()].frames) {
+            std::cout << "    0x" << std::hex << frame.pc << std::dec << ' '
+                      << (frame.function_name.empty() ? "unknown" : frame.function_name) << '\n';
+        }
+    }
+    std::cout << "[lldbg] groups: " << snapshot.threads.size() << " threads in " << grouping->groups.size()
+              << " groups, grouped in " << (double)group_ns / 1e3 << " us\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    const std::optional<HeadlessOptions> options = parse_options(argc, argv);
+    if (!options) {
+        print_usage();
+        return 2;
+    }
+
+    lldbg::g_logger = std::make_unique<lldbg::Logger>(lldbg::LogLevel::Warning);
+    int exit_code = 0;
+
+    {
+        lldbg::Application app;
+        if (options->symbol_preload_threads) {
+            app.symbol_preload_threads = *options->symbol_preload_threads;
+        }
+
+        Timer launch_timer;
+
+        if (options->core_file) {
+            auto err = lldbg::open_core_file(app, options->target[0].c_str(), options->core_file->c_str());
+            if (err) {
+                std::cerr << err->msg << std::endl;
+                print_log_messages();
+                return 1;
+            }
+            std::cout << "[lldbg] opened core file after " << (double)launch_timer.elapsed_ns() / 1e6 << " ms\n";
+        }
+        else if (options->attach_pid || options->attach_name) {
+            auto err = options->attach_pid ? lldbg::attach_to_process(app, *options->attach_pid)
+                                           : lldbg::attach_to_process(app, *options->attach_name, true);
+            if (err) {
+                std::cerr << err->msg << std::endl;
+                print_log_messages();
+                return 1;
+            }
+
+            // waiting for a launch has no deadline of its own
+            if (!lldbg::wait_for_attach(app, options->attach_name ? std::chrono::hours(24) : options->stop_timeout)) {
+                std::cerr << (app.attach_error.empty() ? "timed out attaching" : app.attach_error) << std::endl;
+                lldbg::cancel_attach(app);
+                print_log_messages();
+                return 1;
+            }
+
+            if (!lldbg::wait_for_stop(app, options->stop_timeout)) {
+                std::cerr << "process did not stop after attaching" << std::endl;
+                print_log_messages();
+                return 1;
+            }
+            std::cout << "[lldbg] attached and stopped after " << (double)launch_timer.elapsed_ns() / 1e6 << " ms\n";
+        }
+        else {
+            std::vector<const char*> target_argv;
+            for (size_t i = 1; i < options->target.size(); i++) {
+                target_argv.push_back(options->target[i].c_str());
+            }
+            target_argv.push_back(nullptr);
+
+            auto err = lldbg::create_new_target(app, options->target[0].c_str(), target_argv.data(), true,
+                                                options->workdir);
+            if (err) {
+                std::cerr << err->msg << std::endl;
+                print_log_messages();
+                return 1;
+            }
+
+            if (!lldbg::wait_for_stop(app, options->stop_timeout)) {
+                std::cerr << "process did not stop at entry" << std::endl;
+                print_log_messages();
+                return 1;
+            }
+            std::cout << "[lldbg] launched and stopped at entry after " << (double)launch_timer.elapsed_ns() / 1e6
+                      << " ms\n";
+        }
+
+        for (const auto& breakpoint : options->breakpoints) {
+            if (!lldbg::add_breakpoint(app, breakpoint.first, breakpoint.second)) {
+                std::cout << "[lldbg] could not resolve breakpoint " << breakpoint.first << ':' << breakpoint.second
+                          << '\n';
+                exit_code = 1;
+            }
+        }
+
+        for (const std::string& command : options->commands) {
+            if (command == "next" || command == "step" || command == "finish" || command == "continue") {
+                if (!resume_and_wait(app, command, options->stop_timeout) && !app.exit_dialog) {
+                    exit_code = 1;
+                    break;
+                }
+            }
+            else if (command == "dump") {
+                dump_state(app);
+            }
+            else if (command == "registers") {
+                dump_registers(app);
+            }
+            else if (command == "groups") {
+                dump_thread_groups(app);
+            }
+            else if (command == "breakpoints") {
+                dump_breakpoints(app);
+            }
+            else if (command.rfind("steps ", 0) == 0) {
+                if (!rapid_step_and_wait(app, (uint32_t)std::stoul(command.substr(6)), options->stop_timeout) &&
+                    !app.exit_dialog) {
+                    exit_code = 1;
+                    break;
+                }
+            }
+            else {
+                run_console_command(app, command);
+            }
+
+            print_log_messages();
+
+            if (app.exit_dialog) {
+                break;
+            }
+        }
+
+        if (!app.exit_dialog && lldbg::get_process(app).IsValid()) {
+            lldbg::kill_process(app);
+        }
+
+        print_log_messages();
+    }
+
+    lldbg::g_logger.reset(nullptr);
+
+    return exit_code;
+}